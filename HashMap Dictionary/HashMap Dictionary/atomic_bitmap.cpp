@@ -0,0 +1,159 @@
+/*********************************************************************************
+
+  * FileName:       atomic_bitmap.cpp
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The implementation of the class AtomicBitMap
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#include <thread>
+#include "atomic_bitmap.h"
+#include "bitmap.h"
+
+
+AtomicBitMap::AtomicBitMap(int n)
+{
+	bits_ = (n > 0) ? n : 0;
+	size_ = (bits_ + 63) / 64;
+	map_ = new std::atomic<unsigned long long>[(size_ > 0) ? size_ : 1];
+
+	for (int i = 0; i < size_; i++)
+		map_[i].store(0, std::memory_order_relaxed);
+}
+
+
+AtomicBitMap::~AtomicBitMap()
+{
+	delete[] map_;
+	map_ = nullptr;
+}
+
+
+int AtomicBitMap::GetSize() const
+{
+	return bits_;
+}
+
+
+void AtomicBitMap::Set(int k)
+{
+	if ((k < 0) || (k >= bits_))
+		return;
+
+	map_[k >> 6].fetch_or(1ULL << (k & 63), std::memory_order_acq_rel);
+}
+
+
+void AtomicBitMap::Clear(int k)
+{
+	if ((k < 0) || (k >= bits_))
+		return;
+
+	map_[k >> 6].fetch_and(~(1ULL << (k & 63)), std::memory_order_acq_rel);
+}
+
+
+bool AtomicBitMap::Test(int k) const
+{
+	if ((k < 0) || (k >= bits_))
+		return false;
+
+	return (map_[k >> 6].load(std::memory_order_acquire) & (1ULL << (k & 63))) != 0;
+}
+
+
+bool AtomicBitMap::TestAndSet(int k)
+{
+	if ((k < 0) || (k >= bits_))
+		return false;
+
+	unsigned long long bit = 1ULL << (k & 63);
+
+	// Reading first saves the exclusive ownership of the cache line when the bit is already set, which is common for visited marks
+	if ((map_[k >> 6].load(std::memory_order_acquire) & bit) != 0)
+		return true;
+
+	return (map_[k >> 6].fetch_or(bit, std::memory_order_acq_rel) & bit) != 0;
+}
+
+
+bool AtomicBitMap::TestAndClear(int k)
+{
+	if ((k < 0) || (k >= bits_))
+		return false;
+
+	unsigned long long bit = 1ULL << (k & 63);
+
+	if ((map_[k >> 6].load(std::memory_order_acquire) & bit) == 0)
+		return false;
+
+	return (map_[k >> 6].fetch_and(~bit, std::memory_order_acq_rel) & bit) != 0;
+}
+
+
+int AtomicBitMap::Count() const
+{
+	int count = 0;
+
+	for (int i = 0; i < size_; i++)
+		count += BitMap::PopCount(map_[i].load(std::memory_order_relaxed));
+
+	return count;
+}
+
+
+int AtomicBitMap::Count(int p) const
+{
+	if (p > size_ / 1024)
+		p = size_ / 1024;
+
+	// Small maps are not worth the threads
+	if (p <= 1)
+		return Count();
+
+	int* count = new int[p];
+	std::thread* worker = new std::thread[p];
+
+	for (int t = 0; t < p; t++)
+	{
+		worker[t] = std::thread([this, t, p, count]()
+		{
+			int lo = static_cast<int>(static_cast<long long>(size_) * t / p);
+			int hi = static_cast<int>(static_cast<long long>(size_) * (t + 1) / p);
+			int c = 0;
+
+			for (int i = lo; i < hi; i++)
+				c += BitMap::PopCount(map_[i].load(std::memory_order_relaxed));
+
+			count[t] = c;
+		});
+	}
+
+	int total = 0;
+
+	for (int t = 0; t < p; t++)
+	{
+		worker[t].join();
+		total += count[t];
+	}
+
+	delete[] worker;
+	worker = nullptr;
+	delete[] count;
+	count = nullptr;
+
+	return total;
+}
+
+
+void AtomicBitMap::Reset()
+{
+	for (int i = 0; i < size_; i++)
+		map_[i].store(0, std::memory_order_relaxed);
+}
+
+
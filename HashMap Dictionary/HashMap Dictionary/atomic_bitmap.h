@@ -0,0 +1,108 @@
+/*********************************************************************************
+
+  * FileName:       atomic_bitmap.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class AtomicBitMap
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <atomic>
+
+
+/*
+* A fixed-size bitmap that many threads may set, clear and test at the same time without a lock:
+* every bit operation is a single atomic operation on its 64 bit word, and the map never reallocates,
+* so that it can mark visited IDs in a parallel traversal or the lazily removed buckets of a concurrent hash table
+*/
+class AtomicBitMap
+{
+protected:
+	// Points to the bitmap
+	std::atomic<unsigned long long>* map_;
+	// The number of words in the map
+	int size_;
+	// The number of bits
+	int bits_;
+
+public:
+	AtomicBitMap(int n);
+	~AtomicBitMap();
+
+	/*
+	* Gets the number of bits
+	* @ Return:
+	*                  The number of bits
+	*/
+	int GetSize() const;
+
+	/*
+	* Sets the kth bit
+	* @ Parameter:
+	*       k:         The bit, nothing is done if it is out of range
+	*/
+	void Set(int k);
+
+	/*
+	* Clears the kth bit
+	* @ Parameter:
+	*       k:         The bit, nothing is done if it is out of range
+	*/
+	void Clear(int k);
+
+	/*
+	* Judges whether the kth bit is set
+	* @ Parameter:
+	*       k:         The bit
+	* @ Return:
+	*                  Whether the kth bit is set, false if it is out of range
+	*/
+	bool Test(int k) const;
+
+	/*
+	* Sets the kth bit, tells whether it was set before, exactly one of the threads setting it gets false
+	* @ Parameter:
+	*       k:         The bit, nothing is done if it is out of range
+	* @ Return:
+	*                  Whether the kth bit was set before, false if it is out of range
+	*/
+	bool TestAndSet(int k);
+
+	/*
+	* Clears the kth bit, tells whether it was set before, exactly one of the threads clearing it gets true
+	* @ Parameter:
+	*       k:         The bit, nothing is done if it is out of range
+	* @ Return:
+	*                  Whether the kth bit was set before, false if it is out of range
+	*/
+	bool TestAndClear(int k);
+
+	/*
+	* Counts the set bits, the bits changing meanwhile may or may not be counted
+	* @ Return:
+	*                  The number of set bits
+	*/
+	int Count() const;
+
+	/*
+	* Counts the set bits with p threads, each counting a contiguous range of words
+	* @ Parameter:
+	*       p:         The number of threads
+	* @ Return:
+	*                  The number of set bits
+	*/
+	int Count(int p) const;
+
+	/*
+	* Clears all the bits, which must not run together with other operations
+	*/
+	void Reset();
+};
+
+
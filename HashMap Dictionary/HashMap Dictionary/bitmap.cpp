@@ -12,13 +12,73 @@
 
 #include <memory>
 #include "bitmap.h"
+#include "bitmap_index_out_of_bounds_exception.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BITMAP_AVX2
+#endif
 
-void BitMap::Init(int n)
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+const int BitMap::MAX_WORDS_;
+
+
+void BitMap::Init(long long n)
 {
-	size_ = (n + 7) / 8;
-	map_ = new char[size_];
-	memset(map_, 0, size_);
+	if (n > static_cast<long long>(MAX_WORDS_) * 64)
+		n = static_cast<long long>(MAX_WORDS_) * 64;
+
+	size_ = static_cast<int>((n + 63) / 64);
+	map_ = new unsigned long long[size_];
+	memset(map_, 0, size_ * sizeof(unsigned long long));
+}
+
+
+int BitMap::PopCount(unsigned long long x)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	return static_cast<int>(__popcnt64(x));
+#elif defined(__GNUC__)
+	return __builtin_popcountll(x);
+#else
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+
+int BitMap::CountTrailingZeros(unsigned long long x)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long i = 0;
+	_BitScanForward64(&i, x);
+	return static_cast<int>(i);
+#elif defined(__GNUC__)
+	return __builtin_ctzll(x);
+#else
+	int i = 0;
+
+	while ((x & 1) == 0)
+	{
+		x >>= 1;
+		i++;
+	}
+
+	return i;
+#endif
+}
+
+
+unsigned long long BitMap::GetMask(int lo, int hi)
+{
+	unsigned long long high = (hi == 64) ? ~0ULL : ((1ULL << hi) - 1);
+	return high & ~((1ULL << lo) - 1);
 }
 
 
@@ -37,38 +97,258 @@ BitMap::~BitMap()
 
 void BitMap::Set(int k)
 {
+	if (k < 0)
+		return;
+
 	Expand(k);
-	map_[k >> 3] |= (0x80 >> (k & 0x07));
+	map_[k >> 6] |= (1ULL << (k & 63));
 }
 
 
 void BitMap::Clear(int k)
 {
-	Expand(k);
-	map_[k >> 3] &= ~(0x80 >> (k & 0x07));
+	// The bits beyond the size are already clear
+	if ((k >= 0) && (k < GetBits()))
+		map_[k >> 6] &= ~(1ULL << (k & 63));
 }
 
 
-bool BitMap::Test(int k)
+bool BitMap::Test(int k) const
 {
-	Expand(k);
-	return map_[k >> 3] & (0x80 >> (k & 0x07));
+	if ((k < 0) || (k >= GetBits()))
+		return false;
+
+	return (map_[k >> 6] & (1ULL << (k & 63))) != 0;
 }
 
 
 void BitMap::Expand(int k)
 {
-	if (k < size_ * 8)
+	if (k < GetBits())
+		return;
+
+	if (k >= static_cast<long long>(MAX_WORDS_) * 64)
+		throw BitMapIndexOutOfBoundsException();
+
+	Reserve(2 * (static_cast<long long>(k) + 1));
+}
+
+
+void BitMap::Reserve(long long n)
+{
+	if (n > static_cast<long long>(MAX_WORDS_) * 64)
+		n = static_cast<long long>(MAX_WORDS_) * 64;
+
+	if (n <= GetBits())
 		return;
 
 	int old_size = size_;
-	char* old_map = map_;
+	unsigned long long* old_map = map_;
 
-	Init(2 * k);
+	Init(n);
 
-	memcpy_s(map_, size_, old_map, old_size);
+	memcpy_s(map_, size_ * sizeof(unsigned long long), old_map, old_size * sizeof(unsigned long long));
 	delete[] old_map;
 	old_map = nullptr;
 }
 
 
+long long BitMap::GetBits() const
+{
+	return static_cast<long long>(size_) * 64;
+}
+
+
+void BitMap::SetRange(int lo, int hi)
+{
+	if (lo < 0)
+		lo = 0;
+
+	if (lo >= hi)
+		return;
+
+	Expand(hi - 1);
+
+	int first = lo >> 6, last = (hi - 1) >> 6;
+
+	if (first == last)
+	{
+		map_[first] |= GetMask(lo & 63, ((hi - 1) & 63) + 1);
+		return;
+	}
+
+	map_[first] |= GetMask(lo & 63, 64);
+
+	for (int i = first + 1; i < last; i++)
+		map_[i] = ~0ULL;
+
+	map_[last] |= GetMask(0, ((hi - 1) & 63) + 1);
+}
+
+
+void BitMap::ClearRange(int lo, int hi)
+{
+	if (lo < 0)
+		lo = 0;
+
+	if (hi > GetBits())
+		hi = static_cast<int>(GetBits());
+
+	if (lo >= hi)
+		return;
+
+	int first = lo >> 6, last = (hi - 1) >> 6;
+
+	if (first == last)
+	{
+		map_[first] &= ~GetMask(lo & 63, ((hi - 1) & 63) + 1);
+		return;
+	}
+
+	map_[first] &= ~GetMask(lo & 63, 64);
+
+	for (int i = first + 1; i < last; i++)
+		map_[i] = 0;
+
+	map_[last] &= ~GetMask(0, ((hi - 1) & 63) + 1);
+}
+
+
+int BitMap::Count() const
+{
+	int count = 0;
+
+	for (int i = 0; i < size_; i++)
+		count += PopCount(map_[i]);
+
+	return count;
+}
+
+
+int BitMap::FindNextSet(int k) const
+{
+	if (k < 0)
+		k = 0;
+
+	if (k >= GetBits())
+		return -1;
+
+	// The bits below k in its word are masked off
+	int i = k >> 6;
+	unsigned long long word = map_[i] & ~((1ULL << (k & 63)) - 1);
+
+	while (word == 0)
+	{
+		if (++i == size_)
+			return -1;
+
+		word = map_[i];
+	}
+
+	return i * 64 + CountTrailingZeros(word);
+}
+
+
+int BitMap::FindNextClear(int k) const
+{
+	if (k < 0)
+		k = 0;
+
+	if (k >= GetBits())
+		return k;
+
+	int i = k >> 6;
+	unsigned long long word = ~map_[i] & ~((1ULL << (k & 63)) - 1);
+
+	while (word == 0)
+	{
+		if (++i == size_)
+			return static_cast<int>(GetBits());
+
+		word = ~map_[i];
+	}
+
+	return i * 64 + CountTrailingZeros(word);
+}
+
+
+void BitMap::And(const BitMap& b)
+{
+	int n = (size_ < b.size_) ? size_ : b.size_, i = 0;
+
+#ifdef BITMAP_AVX2
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(map_ + i));
+		__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.map_ + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(map_ + i), _mm256_and_si256(x, y));
+	}
+#endif
+
+	for (; i < n; i++)
+		map_[i] &= b.map_[i];
+
+	// The bits beyond the size of b are clear in b
+	for (; i < size_; i++)
+		map_[i] = 0;
+}
+
+
+void BitMap::Or(const BitMap& b)
+{
+	Reserve(b.GetBits());
+
+	int i = 0;
+
+#ifdef BITMAP_AVX2
+	for (; i + 4 <= b.size_; i += 4)
+	{
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(map_ + i));
+		__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.map_ + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(map_ + i), _mm256_or_si256(x, y));
+	}
+#endif
+
+	for (; i < b.size_; i++)
+		map_[i] |= b.map_[i];
+}
+
+
+void BitMap::Xor(const BitMap& b)
+{
+	Reserve(b.GetBits());
+
+	int i = 0;
+
+#ifdef BITMAP_AVX2
+	for (; i + 4 <= b.size_; i += 4)
+	{
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(map_ + i));
+		__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.map_ + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(map_ + i), _mm256_xor_si256(x, y));
+	}
+#endif
+
+	for (; i < b.size_; i++)
+		map_[i] ^= b.map_[i];
+}
+
+
+void BitMap::AndNot(const BitMap& b)
+{
+	int n = (size_ < b.size_) ? size_ : b.size_, i = 0;
+
+#ifdef BITMAP_AVX2
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(map_ + i));
+		__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.map_ + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(map_ + i), _mm256_andnot_si256(y, x));
+	}
+#endif
+
+	for (; i < n; i++)
+		map_[i] &= ~b.map_[i];
+}
+
+
@@ -13,30 +13,79 @@
 #pragma once
 
 
+/*
+* A bitmap stored in 64 bit words, bit k is bit (k & 63) of word k >> 6,
+* reads never expand the bitmap, the bits beyond its size are clear
+*/
 class BitMap
 {
-private:
+public:
+	// The maximum number of words, so that the number of bits fits in an int
+	const static int MAX_WORDS_ = 0x7FFFFFFF / 64;
+
+protected:
 	// Points to the bitmap
-	char* map_;
-	// The number of chars in the map
+	unsigned long long* map_;
+	// The number of words in the map
 	int size_;
 
-protected:
 	/*
 	* Initializes the bitmap
 	* @ Parameter:
-	*       n:         The size of the bitmap
+	*       n:         The size of the bitmap, at most MAX_WORDS_ * 64 bits
 	*/
-	void Init(int n);
+	void Init(long long n);
+
+	/*
+	* Expands the bitmap to at least n bits, keeps the bits
+	* @ Parameter:
+	*       n:         The size of the bitmap, clamped to MAX_WORDS_ * 64 bits
+	*/
+	void Reserve(long long n);
+
+	/*
+	* Gets the number of bits the words hold
+	* @ Return:
+	*                  The number of bits
+	*/
+	long long GetBits() const;
 
 public:
 	BitMap(int n = 8);
 	~BitMap();
 
 	/*
-	* Sets the kth bit
+	* Counts the set bits of a word
 	* @ Parameter:
-	*       k:         The bit 
+	*       x:         The word
+	* @ Return:
+	*                  The number of set bits
+	*/
+	static int PopCount(unsigned long long x);
+
+	/*
+	* Counts the clear bits below the lowest set bit of a word
+	* @ Parameter:
+	*       x:         The word, which must not be 0
+	* @ Return:
+	*                  The index of the lowest set bit
+	*/
+	static int CountTrailingZeros(unsigned long long x);
+
+	/*
+	* Gets the mask of the bits [lo, hi) of a word
+	* @ Parameter:
+	*       lo:        The lowest bit, in [0, 64)
+	*       hi:        The bit after the highest bit, in (lo, 64]
+	* @ Return:
+	*                  The mask
+	*/
+	static unsigned long long GetMask(int lo, int hi);
+
+	/*
+	* Sets the kth bit, throws BitMapIndexOutOfBoundsException if k is beyond MAX_WORDS_ * 64 bits
+	* @ Parameter:
+	*       k:         The bit, ignored if negative
 	*/
 	void Set(int k);
 
@@ -54,14 +103,83 @@ public:
 	* @ Return:
 	*                  Whether the kth bit is set
 	*/
-	bool Test(int k);
+	bool Test(int k) const;
 
 	/*
-	* Expands the bitmap
+	* Expands the bitmap, throws BitMapIndexOutOfBoundsException if k is beyond MAX_WORDS_ * 64 bits
 	* @ Parameter:
-	*       k:         How many bits to expand to
+	*       k:         The bit the bitmap must hold
 	*/
 	void Expand(int k);
+
+	/*
+	* Sets the bits [lo, hi), throws BitMapIndexOutOfBoundsException if hi is beyond MAX_WORDS_ * 64 bits
+	* @ Parameter:
+	*       lo:        The first bit
+	*       hi:        The bit after the last bit
+	*/
+	void SetRange(int lo, int hi);
+
+	/*
+	* Clears the bits [lo, hi)
+	* @ Parameter:
+	*       lo:        The first bit
+	*       hi:        The bit after the last bit
+	*/
+	void ClearRange(int lo, int hi);
+
+	/*
+	* Counts the set bits
+	* @ Return:
+	*                  The number of set bits
+	*/
+	int Count() const;
+
+	/*
+	* Finds the first set bit at or after the kth bit
+	* @ Parameter:
+	*       k:         The bit to start from
+	* @ Return:
+	*                  The first set bit >= k, or -1 if there's none
+	*/
+	int FindNextSet(int k) const;
+
+	/*
+	* Finds the first clear bit at or after the kth bit, the bits beyond the size are clear
+	* @ Parameter:
+	*       k:         The bit to start from
+	* @ Return:
+	*                  The first clear bit >= k
+	*/
+	int FindNextClear(int k) const;
+
+	/*
+	* Intersects with b, the current bitmap keeps its size
+	* @ Parameter:
+	*       b:         The other bitmap
+	*/
+	void And(const BitMap& b);
+
+	/*
+	* Unites with b, the current bitmap expands to the size of b if it is smaller
+	* @ Parameter:
+	*       b:         The other bitmap
+	*/
+	void Or(const BitMap& b);
+
+	/*
+	* Takes the symmetric difference with b, the current bitmap expands to the size of b if it is smaller
+	* @ Parameter:
+	*       b:         The other bitmap
+	*/
+	void Xor(const BitMap& b);
+
+	/*
+	* Clears the bits set in b
+	* @ Parameter:
+	*       b:         The other bitmap
+	*/
+	void AndNot(const BitMap& b);
 };
 
 
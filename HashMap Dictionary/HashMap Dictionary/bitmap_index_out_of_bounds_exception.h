@@ -0,0 +1,28 @@
+/*********************************************************************************
+
+  * FileName:       bitmap_index_out_of_bounds_exception.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class BitMapIndexOutOfBoundsException
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <exception>
+
+
+class BitMapIndexOutOfBoundsException : public std::exception
+{
+public:
+	virtual const char* what() const throw()
+	{
+		return "The given bit is beyond the largest bitmap !";
+	}
+};
+
+
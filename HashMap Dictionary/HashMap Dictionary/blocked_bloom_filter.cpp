@@ -0,0 +1,129 @@
+/*********************************************************************************
+
+  * FileName:       blocked_bloom_filter.cpp
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The implementation of the class BlockedBloomFilter
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#include <cstring>
+#include "blocked_bloom_filter.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BLOCKED_BLOOM_FILTER_AVX2
+#endif
+
+
+const int BloomFilterBlock::WORDS_;
+const unsigned int BlockedBloomFilter::SALT_[BloomFilterBlock::WORDS_] = { 0x47B6137BU, 0x44974D91U, 0x8824AD5BU, 0xA2B7289DU, 0x705495C7U, 0x2DF1424BU, 0x9EFC4947U, 0x5C6BFB31U };
+
+
+int BlockedBloomFilter::GetBlock(unsigned long long h) const
+{
+	// Multiplying and shifting maps the high bits onto [0, size) without a division
+	return static_cast<int>(((h >> 32) * static_cast<unsigned long long>(size_)) >> 32);
+}
+
+
+int BlockedBloomFilter::GetBit(unsigned long long h, int i)
+{
+	return static_cast<int>((static_cast<unsigned int>(h) * SALT_[i]) >> 27);
+}
+
+
+BlockedBloomFilter::BlockedBloomFilter(int n, bool counting, int bits)
+{
+	long long total = static_cast<long long>((n > 0) ? n : 1) * ((bits > 0) ? bits : 1);
+	size_ = static_cast<int>((total + 255) / 256);
+	block_ = new BloomFilterBlock[size_];
+	counter_ = (counting == true) ? new unsigned char[static_cast<size_t>(size_) * 256] : nullptr;
+	Clear();
+}
+
+
+BlockedBloomFilter::~BlockedBloomFilter()
+{
+	delete[] block_;
+	block_ = nullptr;
+	delete[] counter_;
+	counter_ = nullptr;
+}
+
+
+void BlockedBloomFilter::Insert(unsigned long long h)
+{
+	int b = GetBlock(h);
+
+	for (int i = 0; i < BloomFilterBlock::WORDS_; i++)
+	{
+		int bit = GetBit(h, i);
+		block_[b].word_[i] |= 1U << bit;
+
+		// A saturated counter can no longer tell how many keys share the bit, so it is never decreased
+		if ((counter_ != nullptr) && (counter_[b * 256 + i * 32 + bit] < 255))
+			counter_[b * 256 + i * 32 + bit]++;
+	}
+}
+
+
+bool BlockedBloomFilter::Remove(unsigned long long h)
+{
+	if (counter_ == nullptr)
+		return false;
+
+	int b = GetBlock(h);
+
+	for (int i = 0; i < BloomFilterBlock::WORDS_; i++)
+	{
+		int bit = GetBit(h, i);
+		unsigned char& c = counter_[b * 256 + i * 32 + bit];
+
+		if ((c > 0) && (c < 255) && (--c == 0))
+			block_[b].word_[i] &= ~(1U << bit);
+	}
+
+	return true;
+}
+
+
+bool BlockedBloomFilter::MayContain(unsigned long long h) const
+{
+	const BloomFilterBlock& block = block_[GetBlock(h)];
+
+#ifdef BLOCKED_BLOOM_FILTER_AVX2
+	__m256i salt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(SALT_));
+	__m256i bit = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(h)), salt), 27);
+	__m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), bit);
+
+	// Whether every bit of the mask is set in the block
+	return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(block.word_)), mask) != 0;
+#else
+	for (int i = 0; i < BloomFilterBlock::WORDS_; i++)
+		if ((block.word_[i] & (1U << GetBit(h, i))) == 0)
+			return false;
+
+	return true;
+#endif
+}
+
+
+void BlockedBloomFilter::Clear()
+{
+	memset(block_, 0, static_cast<size_t>(size_) * sizeof(BloomFilterBlock));
+
+	if (counter_ != nullptr)
+		memset(counter_, 0, static_cast<size_t>(size_) * 256);
+}
+
+
+bool BlockedBloomFilter::IsCounting() const
+{
+	return counter_ != nullptr;
+}
+
+
@@ -0,0 +1,115 @@
+/*********************************************************************************
+
+  * FileName:       blocked_bloom_filter.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class BlockedBloomFilter
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+class alignas(32) BloomFilterBlock
+{
+public:
+	// The number of words in a block
+	const static int WORDS_ = 8;
+	// The words, each holding one of the bits of a key
+	unsigned int word_[WORDS_];
+};
+
+
+/*
+* A split block Bloom filter: a key sets one bit in each of the 8 words of a single 256 bit block,
+* so that a lookup reads one aligned block, which never crosses a cache line, and tests all 8 bits at once,
+* with AVX2 when the compiler targets it,
+* in the counting mode every bit also has a saturating 8 bit counter, touched only by insertions and removals,
+* so that removals clear the bits no other key needs,
+* the blocks hold their own 32 bit words instead of the 64 bit words of BitMap, so that each of the 8 bits of a key
+* gets a word of its own and one SIMD lane can test it, and so that the blocks are aligned to 32 bytes
+*/
+class BlockedBloomFilter
+{
+protected:
+	// The odd multipliers choosing the bit of each word
+	const static unsigned int SALT_[BloomFilterBlock::WORDS_];
+	// The blocks
+	BloomFilterBlock* block_;
+	// The number of blocks
+	int size_;
+	// The counters of the bits, nullptr unless in the counting mode
+	unsigned char* counter_;
+
+	/*
+	* Gets the block of a hash code, by its high 32 bits
+	* @ Parameter:
+	*       h:         The hash code
+	* @ Return:
+	*                  The index of the block
+	*/
+	int GetBlock(unsigned long long h) const;
+
+	/*
+	* Gets the bit of a hash code in word i, by its low 32 bits
+	* @ Parameter:
+	*       h:         The hash code
+	*       i:         The index of the word
+	* @ Return:
+	*                  The index of the bit in the word
+	*/
+	static int GetBit(unsigned long long h, int i);
+
+public:
+	/*
+	* Creates a filter for n keys
+	* @ Parameter:
+	*       n:         The expected number of keys
+	*       counting:  Whether to keep the counters, which Remove() needs
+	*       bits:      The number of bits per key, 10 gives about 1% false positives
+	*/
+	BlockedBloomFilter(int n, bool counting = false, int bits = 10);
+	~BlockedBloomFilter();
+
+	/*
+	* Adds a key
+	* @ Parameter:
+	*       h:         The 64 bit hash code of the key
+	*/
+	void Insert(unsigned long long h);
+
+	/*
+	* Removes a key added before, only in the counting mode
+	* @ Parameter:
+	*       h:         The 64 bit hash code of the key
+	* @ Return:
+	*                  Whether the key is removed, false if the filter is not counting
+	*/
+	bool Remove(unsigned long long h);
+
+	/*
+	* Judges whether a key may have been added
+	* @ Parameter:
+	*       h:         The 64 bit hash code of the key
+	* @ Return:
+	*                  false if the key has surely not been added
+	*/
+	bool MayContain(unsigned long long h) const;
+
+	/*
+	* Removes all the keys
+	*/
+	void Clear();
+
+	/*
+	* Judges whether the filter keeps the counters
+	* @ Return:
+	*                  Whether the filter is counting
+	*/
+	bool IsCounting() const;
+};
+
+
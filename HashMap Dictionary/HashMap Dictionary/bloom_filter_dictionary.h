@@ -0,0 +1,246 @@
+/*********************************************************************************
+
+  * FileName:       bloom_filter_dictionary.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class BloomFilterDictionary
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <utility>
+#include "dictionary.h"
+#include "blocked_bloom_filter.h"
+#include "hash.h"
+
+
+/*
+* A Bloom filter in front of any dictionary: every key put into the dictionary is added to the filter,
+* so that most lookups of missing keys end after one cache line instead of a search chain or a root-to-leaf path,
+* removals are passed to a counting filter, or, with a plain filter, leave their bits behind,
+* which only raises the false positives until Rebuild(),
+* the dictionary must be empty when it is wrapped, and must be modified only through the wrapper since then
+*/
+template<typename K, typename V, typename H = Hash<K>> class BloomFilterDictionary: public Dictionary<K, V>
+{
+protected:
+	// The hash function of the filter
+	H hash_;
+	// The dictionary behind the filter, which is not owned
+	Dictionary<K, V>* dict_;
+	// The filter
+	BlockedBloomFilter* filter_;
+	// Whether the filter is counting
+	bool counting_;
+	// The number of removals the filter still remembers the keys of
+	int stale_;
+
+	/*
+	* Gets the 64 bit hash code of k for the filter
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The hash code
+	*/
+	unsigned long long GetHash(const K& k) const;
+
+public:
+	/*
+	* Wraps an empty dictionary
+	* @ Parameter:
+	*       d:         The dictionary, which must outlive the wrapper
+	*       n:         The expected number of keys
+	*       counting:  Whether to keep counters, so that removals clear the bits of the filter
+	*/
+	BloomFilterDictionary(Dictionary<K, V>* d, int n, bool counting = true);
+	~BloomFilterDictionary();
+
+	/*
+	* Gets the number of entries
+	* @ Return:
+	*                  The number of entries
+	*/
+	int GetSize() const;
+
+	/*
+	* Inserts an entry
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	bool Put(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k, asks the dictionary only if the filter may contain k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k
+	*/
+	V* Get(K k);
+
+	/*
+	* Inserts an entry, or updates the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether an entry is inserted, false if the value of an entry is updated
+	*/
+	bool Upsert(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k, inserts an entry with the default value first if there's none
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k, valid until the next insertion or removal
+	*/
+	V& GetOrInsert(K k);
+
+	/*
+	* Removes the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  Whether removal is successful
+	*/
+	bool Remove(K k);
+
+	/*
+	* Gets the number of removed keys whose bits are still in the filter, 0 for a counting filter
+	* @ Return:
+	*                  The number of stale keys
+	*/
+	int GetStale() const;
+
+	/*
+	* Rebuilds the filter from the keys of the dictionary, sized for at least n keys,
+	* for a dictionary that offers Traverse(), such as HashMapDictionary
+	* @ Parameter:
+	*       d:         The dictionary behind the filter, as its own type
+	*       n:         The expected number of keys
+	*/
+	template<typename D> void Rebuild(D& d, int n);
+};
+
+
+template<typename K, typename V, typename H> unsigned long long BloomFilterDictionary<K, V, H>::GetHash(const K& k) const
+{
+	unsigned long long h = static_cast<unsigned long long>(hash_(k));
+
+	// A 32 bit hash code leaves the high half, which chooses the block, empty, so it is spread first
+	return (sizeof(size_t) < sizeof(unsigned long long)) ? h * 0x9E3779B97F4A7C15ULL : h;
+}
+
+
+template<typename K, typename V, typename H> BloomFilterDictionary<K, V, H>::BloomFilterDictionary(Dictionary<K, V>* d, int n, bool counting):
+	dict_(d), counting_(counting), stale_(0)
+{
+	filter_ = new BlockedBloomFilter(n, counting);
+}
+
+
+template<typename K, typename V, typename H> BloomFilterDictionary<K, V, H>::~BloomFilterDictionary()
+{
+	delete filter_;
+	filter_ = nullptr;
+}
+
+
+template<typename K, typename V, typename H> int BloomFilterDictionary<K, V, H>::GetSize() const
+{
+	return dict_->GetSize();
+}
+
+
+template<typename K, typename V, typename H> bool BloomFilterDictionary<K, V, H>::Put(K k, V v)
+{
+	unsigned long long h = GetHash(k);
+
+	if (dict_->Put(std::move(k), std::move(v)) == false)
+		return false;
+
+	filter_->Insert(h);
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H> V* BloomFilterDictionary<K, V, H>::Get(K k)
+{
+	if (filter_->MayContain(GetHash(k)) == false)
+		return nullptr;
+
+	return dict_->Get(std::move(k));
+}
+
+
+template<typename K, typename V, typename H> bool BloomFilterDictionary<K, V, H>::Upsert(K k, V v)
+{
+	unsigned long long h = GetHash(k);
+
+	if (dict_->Upsert(std::move(k), std::move(v)) == false)
+		return false;
+
+	filter_->Insert(h);
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H> V& BloomFilterDictionary<K, V, H>::GetOrInsert(K k)
+{
+	unsigned long long h = GetHash(k);
+	int size = dict_->GetSize();
+	V& v = dict_->GetOrInsert(std::move(k));
+
+	if (dict_->GetSize() > size)
+		filter_->Insert(h);
+
+	return v;
+}
+
+
+template<typename K, typename V, typename H> bool BloomFilterDictionary<K, V, H>::Remove(K k)
+{
+	unsigned long long h = GetHash(k);
+
+	// A key the filter has never seen is not in the dictionary either
+	if ((filter_->MayContain(h) == false) || (dict_->Remove(std::move(k)) == false))
+		return false;
+
+	if (filter_->Remove(h) == false)
+		stale_++;
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H> int BloomFilterDictionary<K, V, H>::GetStale() const
+{
+	return stale_;
+}
+
+
+template<typename K, typename V, typename H> template<typename D> void BloomFilterDictionary<K, V, H>::Rebuild(D& d, int n)
+{
+	if (n < d.GetSize())
+		n = d.GetSize();
+
+	delete filter_;
+	filter_ = new BlockedBloomFilter(n, counting_);
+	stale_ = 0;
+
+	auto visit = [this](const K& k, V&) { filter_->Insert(GetHash(k)); };
+	d.Traverse(visit);
+}
+
+
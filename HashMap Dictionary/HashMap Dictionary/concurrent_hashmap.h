@@ -0,0 +1,246 @@
+/*********************************************************************************
+
+  * FileName:       concurrent_hashmap.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class ConcurrentHashMap
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include "hashmap_dictionary.h"
+
+
+template<typename K, typename V, typename H, typename E> class alignas(64) ConcurrentHashMapShard
+{
+public:
+	// The hash map of the shard, whose capacity is a power of 2
+	HashMapDictionary<K, V, H, E> map_;
+	// Guards the hash map, shared by the readers and exclusive to the writers
+	std::shared_mutex lock_;
+
+	ConcurrentHashMapShard(): map_(16, true)
+	{
+	}
+};
+
+
+/*
+* A concurrent hash map: the entries are spread by the high bits of their hash codes over independent shards,
+* each a HashMapDictionary guarded by a reader-writer lock, so that readers never block each other
+* and writers only block the operations on the same shard,
+* values are copied out instead of pointed to, since an entry may move as soon as the lock is released
+*/
+template<typename K, typename V, typename H = Hash<K>, typename E = KeyEqual<K>> class ConcurrentHashMap
+{
+protected:
+	// The hash function, whose high bits choose the shard
+	H hash_;
+	// The number of bits choosing the shard
+	int shard_bits_;
+	// Points to the shards
+	ConcurrentHashMapShard<K, V, H, E>* shard_;
+	// The number of entries
+	std::atomic<int> size_;
+
+	/*
+	* Gets the shard of k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The shard of k
+	*/
+	ConcurrentHashMapShard<K, V, H, E>& GetShard(const K& k);
+
+public:
+	ConcurrentHashMap(int p = static_cast<int>(std::thread::hardware_concurrency()), int c = 4);
+	~ConcurrentHashMap();
+
+	/*
+	* Gets the number of entries
+	* @ Return:
+	*                  The number of entries
+	*/
+	int GetSize() const;
+
+	/*
+	* Inserts an entry
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether insertion is successful, false if there's already an entry with key == k
+	*/
+	bool Put(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The copy of the value
+	* @ Return:
+	*                  Whether there's an entry with key == k
+	*/
+	bool Get(K k, V& v);
+
+	/*
+	* Removes the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  Whether removal is successful
+	*/
+	bool Remove(K k);
+
+	/*
+	* Inserts an entry, or updates the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether an entry is inserted, false if an entry is updated
+	*/
+	bool Upsert(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k, inserts an entry with value f(k) first if there's none,
+	* f is called at most once and under the lock of the shard, so it should be short
+	* @ Parameter:
+	*       k:         The key
+	*       f:         The function computing the value from the key
+	* @ Return:
+	*                  The copy of the value
+	*/
+	template<typename F> V ComputeIfAbsent(K k, F f);
+};
+
+
+template<typename K, typename V, typename H, typename E> ConcurrentHashMapShard<K, V, H, E>& ConcurrentHashMap<K, V, H, E>::GetShard(const K& k)
+{
+	if (shard_bits_ == 0)
+		return shard_[0];
+
+	return shard_[hash_(k) >> (8 * sizeof(size_t) - shard_bits_)];
+}
+
+
+template<typename K, typename V, typename H, typename E> ConcurrentHashMap<K, V, H, E>::ConcurrentHashMap(int p, int c): size_(0)
+{
+	int shards = ((p > 0) ? p : 1) * ((c > 0) ? c : 1);
+
+	shard_bits_ = 0;
+
+	while ((1 << shard_bits_) < shards)
+		shard_bits_++;
+
+	shard_ = new ConcurrentHashMapShard<K, V, H, E>[1 << shard_bits_];
+}
+
+
+template<typename K, typename V, typename H, typename E> ConcurrentHashMap<K, V, H, E>::~ConcurrentHashMap()
+{
+	delete[] shard_;
+	shard_ = nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> int ConcurrentHashMap<K, V, H, E>::GetSize() const
+{
+	return size_.load();
+}
+
+
+template<typename K, typename V, typename H, typename E> bool ConcurrentHashMap<K, V, H, E>::Put(K k, V v)
+{
+	ConcurrentHashMapShard<K, V, H, E>& shard = GetShard(k);
+	std::unique_lock<std::shared_mutex> guard(shard.lock_);
+
+	if (shard.map_.Put(k, v) == false)
+		return false;
+
+	size_++;
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool ConcurrentHashMap<K, V, H, E>::Get(K k, V& v)
+{
+	ConcurrentHashMapShard<K, V, H, E>& shard = GetShard(k);
+	std::shared_lock<std::shared_mutex> guard(shard.lock_);
+	V* x = shard.map_.Get(k);
+
+	if (x == nullptr)
+		return false;
+
+	v = *x;
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool ConcurrentHashMap<K, V, H, E>::Remove(K k)
+{
+	ConcurrentHashMapShard<K, V, H, E>& shard = GetShard(k);
+	std::unique_lock<std::shared_mutex> guard(shard.lock_);
+
+	if (shard.map_.Remove(k) == false)
+		return false;
+
+	size_--;
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool ConcurrentHashMap<K, V, H, E>::Upsert(K k, V v)
+{
+	ConcurrentHashMapShard<K, V, H, E>& shard = GetShard(k);
+	std::unique_lock<std::shared_mutex> guard(shard.lock_);
+
+	if (shard.map_.Upsert(k, v) == false)
+		return false;
+
+	size_++;
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename F> V ConcurrentHashMap<K, V, H, E>::ComputeIfAbsent(K k, F f)
+{
+	ConcurrentHashMapShard<K, V, H, E>& shard = GetShard(k);
+
+	// Most calls find the entry, so a shared lock is tried first
+	{
+		std::shared_lock<std::shared_mutex> guard(shard.lock_);
+		V* x = shard.map_.Get(k);
+
+		if (x != nullptr)
+			return *x;
+	}
+
+	std::unique_lock<std::shared_mutex> guard(shard.lock_);
+	V* x = shard.map_.Get(k);
+
+	// Another writer may have inserted it between the locks
+	if (x != nullptr)
+		return *x;
+
+	V v = f(k);
+	shard.map_.Put(k, v);
+	size_++;
+
+	return v;
+}
+
+
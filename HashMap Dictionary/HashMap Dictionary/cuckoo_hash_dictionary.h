@@ -0,0 +1,534 @@
+/*********************************************************************************
+
+  * FileName:       cuckoo_hash_dictionary.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class CuckooHashDictionary
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <utility>
+#include "dictionary.h"
+#include "entry.h"
+#include "hash.h"
+#include "cuckoo_hash_overflow_exception.h"
+
+
+template<typename K, typename V> class alignas(64) CuckooHashBucket
+{
+public:
+	// The number of slots in a bucket
+	const static int SLOTS_ = 4;
+	// The slots
+	Entry<K, V> slot_[SLOTS_];
+	// The occupancy flag of the slots, bit i for slot i
+	unsigned char occupied_;
+
+	CuckooHashBucket(): occupied_(0)
+	{
+	}
+};
+
+
+/*
+* A cuckoo hash map: every key may only live in the 4 slots of one of its two buckets, or in a small stash,
+* so that a search reads at most two buckets, each aligned to a cache line when the entries are small,
+* an insertion into two full buckets makes room by moving entries to their other buckets
+* along the shortest path found by a breadth-first search, and keys that still don't fit go to the stash,
+* the insertions throw CuckooHashOverflowException when more than 2 * SLOTS_ + STASH_SIZE_ keys have the same hash code
+*/
+template<typename K, typename V, typename H = Hash<K>, typename E = KeyEqual<K>> class CuckooHashDictionary: public Dictionary<K, V>
+{
+protected:
+	// The number of slots in a bucket
+	const static int SLOTS_ = CuckooHashBucket<K, V>::SLOTS_;
+	// The capacity of the stash
+	const static int STASH_SIZE_ = 8;
+	// The maximum number of buckets visited by the breadth-first search
+	const static int MAX_SEARCH_ = 256;
+	// The largest number of buckets, so that the number of slots stays within int
+	const static int MAX_CAPACITY_ = 1 << 28;
+	// The hash function
+	H hash_;
+	// The key comparison
+	E equal_;
+	// The buckets
+	CuckooHashBucket<K, V>* bucket_;
+	// The number of buckets, a power of 2
+	int capacity_;
+	// The number of entries
+	int size_;
+	// The stash
+	Entry<K, V> stash_[STASH_SIZE_];
+	// The number of entries in the stash
+	int stash_size_;
+
+	/*
+	* Gets the two buckets of k
+	* @ Parameter:
+	*       k:         The key, or anything H accepts in its place
+	*       b1:        The first bucket
+	*       b2:        The second bucket
+	*/
+	template<typename Q> void GetBuckets(const Q& k, int& b1, int& b2) const;
+
+	/*
+	* Finds the entry with key equal to k
+	* @ Parameter:
+	*       k:         The key, or anything H and E accept in its place
+	* @ Return:
+	*                  Points to the entry, or nullptr if there's none
+	*/
+	template<typename Q> Entry<K, V>* Find(const Q& k);
+
+	/*
+	* Finds a free slot in bucket b
+	* @ Parameter:
+	*       b:         The index of the bucket
+	* @ Return:
+	*                  The index of the slot, or -1 if the bucket is full
+	*/
+	int GetFreeSlot(int b) const;
+
+	/*
+	* Places the entry, which is not in the map, into one of its buckets, moving other entries if needed, or into the stash
+	* @ Parameter:
+	*       e:         The entry, which is moved from only if it is placed
+	* @ Return:
+	*                  Points to the placed entry, or nullptr if there's no room
+	*/
+	Entry<K, V>* Place(Entry<K, V>& e);
+
+	/*
+	* Counts the entries whose keys have the same hash code as k, which always share the two buckets of k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The number of such entries in the buckets of k and in the stash
+	*/
+	int CountSameHash(const K& k) const;
+
+	/*
+	* Inserts the entry, which is not in the map, expands the buckets until it fits,
+	* throws CuckooHashOverflowException if it can never fit, because more keys with the same hash code
+	* than the two buckets and the stash hold would be in the map, or because the buckets can no longer expand
+	* @ Parameter:
+	*       e:         The entry
+	* @ Return:
+	*                  Points to the inserted entry
+	*/
+	Entry<K, V>* Insert(Entry<K, V>&& e);
+
+	/*
+	* Doubles the buckets and places all the entries again, until all of them fit
+	*/
+	void Rehash();
+
+public:
+	CuckooHashDictionary(int c = 16);
+	~CuckooHashDictionary();
+
+	/*
+	* Gets the number of entries
+	* @ Return:
+	*                  The number of entries
+	*/
+	int GetSize() const;
+
+	/*
+	* Inserts an entry
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	bool Put(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k
+	*/
+	V* Get(K k);
+
+	/*
+	* Gets the value of the entry with key equal to k, without constructing a key from k
+	* @ Parameter:
+	*       k:         Anything H and E accept in place of a key
+	* @ Return:
+	*                  The value of the entry with key equal to k
+	*/
+	template<typename Q> V* Get(const Q& k);
+
+	/*
+	* Inserts an entry, or updates the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether an entry is inserted, false if the value of an entry is updated
+	*/
+	bool Upsert(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k, inserts an entry with the default value first if there's none
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k, valid until the next insertion or removal
+	*/
+	V& GetOrInsert(K k);
+
+	/*
+	* Inserts an entry whose value is constructed from a, only if there's no entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       a:         The arguments of the constructor of the value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	template<typename... A> bool TryEmplace(K k, A&&... a);
+
+	/*
+	* Removes the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  Whether removal is successful
+	*/
+	bool Remove(K k);
+};
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> void CuckooHashDictionary<K, V, H, E>::GetBuckets(const Q& k, int& b1, int& b2) const
+{
+	// The low bits of the mixed hash code choose the first bucket, the high bits of its Fibonacci hash the second
+	unsigned long long h = static_cast<unsigned long long>(hash_(k));
+	b1 = static_cast<int>(h & static_cast<unsigned long long>(capacity_ - 1));
+	b2 = static_cast<int>(((h * 0x9E3779B97F4A7C15ULL) >> 32) & static_cast<unsigned long long>(capacity_ - 1));
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> Entry<K, V>* CuckooHashDictionary<K, V, H, E>::Find(const Q& k)
+{
+	int b[2] = { 0, 0 };
+	GetBuckets(k, b[0], b[1]);
+
+	for (int i = 0; i < 2; i++)
+		for (int j = 0; j < SLOTS_; j++)
+			if (((bucket_[b[i]].occupied_ & (1 << j)) != 0) && (equal_(bucket_[b[i]].slot_[j].key_, k) == true))
+				return &(bucket_[b[i]].slot_[j]);
+
+	for (int i = 0; i < stash_size_; i++)
+		if (equal_(stash_[i].key_, k) == true)
+			return &(stash_[i]);
+
+	return nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> int CuckooHashDictionary<K, V, H, E>::GetFreeSlot(int b) const
+{
+	for (int j = 0; j < SLOTS_; j++)
+		if ((bucket_[b].occupied_ & (1 << j)) == 0)
+			return j;
+
+	return -1;
+}
+
+
+template<typename K, typename V, typename H, typename E> Entry<K, V>* CuckooHashDictionary<K, V, H, E>::Place(Entry<K, V>& e)
+{
+	// Every node of the search is a bucket, reached by moving the entry in slot slot[i] of bucket bucket[parent[i]]
+	int bucket[MAX_SEARCH_], parent[MAX_SEARCH_], slot[MAX_SEARCH_];
+	int n = 2, b1 = 0, b2 = 0;
+
+	GetBuckets(e.key_, b1, b2);
+	bucket[0] = b1;
+	bucket[1] = b2;
+	parent[0] = parent[1] = -1;
+	slot[0] = slot[1] = -1;
+
+	for (int i = 0; i < n; i++)
+	{
+		int free = GetFreeSlot(bucket[i]);
+
+		if (free >= 0)
+		{
+			// Moves the entries along the path backward, each into the slot freed by the one after it
+			for (; parent[i] >= 0; i = parent[i])
+			{
+				CuckooHashBucket<K, V>& from = bucket_[bucket[parent[i]]];
+				bucket_[bucket[i]].slot_[free] = std::move(from.slot_[slot[i]]);
+				bucket_[bucket[i]].occupied_ |= (1 << free);
+				from.occupied_ &= ~(1 << slot[i]);
+				free = slot[i];
+			}
+
+			bucket_[bucket[i]].slot_[free] = std::move(e);
+			bucket_[bucket[i]].occupied_ |= (1 << free);
+
+			return &(bucket_[bucket[i]].slot_[free]);
+		}
+
+		for (int j = 0; (j < SLOTS_) && (n < MAX_SEARCH_); j++)
+		{
+			int alt1 = 0, alt2 = 0;
+			GetBuckets(bucket_[bucket[i]].slot_[j].key_, alt1, alt2);
+			int alt = (alt1 == bucket[i]) ? alt2 : alt1;
+
+			// A path visiting a bucket twice would move an entry that has already moved
+			bool visited = false;
+
+			for (int x = 0; (x < n) && (visited == false); x++)
+				visited = (bucket[x] == alt);
+
+			if (visited == true)
+				continue;
+
+			bucket[n] = alt;
+			parent[n] = i;
+			slot[n] = j;
+			n++;
+		}
+	}
+
+	if (stash_size_ == STASH_SIZE_)
+		return nullptr;
+
+	stash_[stash_size_] = std::move(e);
+
+	return &(stash_[stash_size_++]);
+}
+
+
+template<typename K, typename V, typename H, typename E> int CuckooHashDictionary<K, V, H, E>::CountSameHash(const K& k) const
+{
+	int b[2] = { 0, 0 }, n = 0;
+	size_t h = hash_(k);
+
+	GetBuckets(k, b[0], b[1]);
+
+	for (int i = 0; i < ((b[0] != b[1]) ? 2 : 1); i++)
+		for (int j = 0; j < SLOTS_; j++)
+			if (((bucket_[b[i]].occupied_ & (1 << j)) != 0) && (hash_(bucket_[b[i]].slot_[j].key_) == h))
+				n++;
+
+	for (int i = 0; i < stash_size_; i++)
+		if (hash_(stash_[i].key_) == h)
+			n++;
+
+	return n;
+}
+
+
+template<typename K, typename V, typename H, typename E> Entry<K, V>* CuckooHashDictionary<K, V, H, E>::Insert(Entry<K, V>&& e)
+{
+	// Keeps the load factor below 90%, where the searches stay short
+	if (((size_ + 1LL) * 10 > static_cast<long long>(capacity_) * SLOTS_ * 9) && (capacity_ < MAX_CAPACITY_))
+		Rehash();
+
+	Entry<K, V>* x = nullptr;
+
+	while ((x = Place(e)) == nullptr)
+	{
+		// No number of buckets separates keys with the same hash code, so doubling would never end
+		if ((CountSameHash(e.key_) + 1 > 2 * SLOTS_ + STASH_SIZE_) || (capacity_ >= MAX_CAPACITY_))
+			throw CuckooHashOverflowException();
+
+		Rehash();
+	}
+
+	size_++;
+
+	return x;
+}
+
+
+template<typename K, typename V, typename H, typename E> void CuckooHashDictionary<K, V, H, E>::Rehash()
+{
+	int n = 0;
+	Entry<K, V>* all = new Entry<K, V>[size_];
+
+	for (int b = 0; b < capacity_; b++)
+		for (int j = 0; j < SLOTS_; j++)
+			if ((bucket_[b].occupied_ & (1 << j)) != 0)
+				all[n++] = std::move(bucket_[b].slot_[j]);
+
+	for (int i = 0; i < stash_size_; i++)
+		all[n++] = std::move(stash_[i]);
+
+	while (true)
+	{
+		delete[] bucket_;
+		capacity_ *= 2;
+		bucket_ = new CuckooHashBucket<K, V>[capacity_];
+		stash_size_ = 0;
+
+		int i = 0;
+
+		while ((i < n) && (Place(all[i]) != nullptr))
+			i++;
+
+		if (i == n)
+			break;
+
+		// Gathers the placed entries and the rest again, then tries twice the buckets
+		Entry<K, V>* retry = new Entry<K, V>[n];
+		int m = 0;
+
+		for (int b = 0; b < capacity_; b++)
+			for (int j = 0; j < SLOTS_; j++)
+				if ((bucket_[b].occupied_ & (1 << j)) != 0)
+					retry[m++] = std::move(bucket_[b].slot_[j]);
+
+		for (int x = 0; x < stash_size_; x++)
+			retry[m++] = std::move(stash_[x]);
+
+		for (; i < n; i++)
+			retry[m++] = std::move(all[i]);
+
+		delete[] all;
+		all = retry;
+	}
+
+	delete[] all;
+	all = nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> CuckooHashDictionary<K, V, H, E>::CuckooHashDictionary(int c)
+{
+	capacity_ = 2;
+
+	while (capacity_ * SLOTS_ < c)
+		capacity_ *= 2;
+
+	size_ = 0;
+	stash_size_ = 0;
+	bucket_ = new CuckooHashBucket<K, V>[capacity_];
+}
+
+
+template<typename K, typename V, typename H, typename E> CuckooHashDictionary<K, V, H, E>::~CuckooHashDictionary()
+{
+	delete[] bucket_;
+	bucket_ = nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> int CuckooHashDictionary<K, V, H, E>::GetSize() const
+{
+	return size_;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool CuckooHashDictionary<K, V, H, E>::Put(K k, V v)
+{
+	if (Find(k) != nullptr)
+		return false;
+
+	Insert(Entry<K, V>(std::move(k), std::move(v)));
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> V* CuckooHashDictionary<K, V, H, E>::Get(K k)
+{
+	Entry<K, V>* x = Find(k);
+	return (x != nullptr) ? &(x->value_) : nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> V* CuckooHashDictionary<K, V, H, E>::Get(const Q& k)
+{
+	Entry<K, V>* x = Find(k);
+	return (x != nullptr) ? &(x->value_) : nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool CuckooHashDictionary<K, V, H, E>::Upsert(K k, V v)
+{
+	Entry<K, V>* x = Find(k);
+
+	if (x != nullptr)
+	{
+		x->value_ = std::move(v);
+		return false;
+	}
+
+	Insert(Entry<K, V>(std::move(k), std::move(v)));
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> V& CuckooHashDictionary<K, V, H, E>::GetOrInsert(K k)
+{
+	Entry<K, V>* x = Find(k);
+
+	if (x == nullptr)
+		x = Insert(Entry<K, V>(std::move(k), V()));
+
+	return x->value_;
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename... A> bool CuckooHashDictionary<K, V, H, E>::TryEmplace(K k, A&&... a)
+{
+	if (Find(k) != nullptr)
+		return false;
+
+	Insert(Entry<K, V>(std::move(k), V(std::forward<A>(a)...)));
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool CuckooHashDictionary<K, V, H, E>::Remove(K k)
+{
+	int b[2] = { 0, 0 };
+	GetBuckets(k, b[0], b[1]);
+
+	for (int i = 0; i < 2; i++)
+	{
+		for (int j = 0; j < SLOTS_; j++)
+		{
+			if (((bucket_[b[i]].occupied_ & (1 << j)) != 0) && (equal_(bucket_[b[i]].slot_[j].key_, k) == true))
+			{
+				bucket_[b[i]].slot_[j] = Entry<K, V>();
+				bucket_[b[i]].occupied_ &= ~(1 << j);
+				size_--;
+
+				return true;
+			}
+		}
+	}
+
+	for (int i = 0; i < stash_size_; i++)
+	{
+		if (equal_(stash_[i].key_, k) == true)
+		{
+			// Keeps the stash compact
+			stash_[i] = std::move(stash_[--stash_size_]);
+			stash_[stash_size_] = Entry<K, V>();
+			size_--;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
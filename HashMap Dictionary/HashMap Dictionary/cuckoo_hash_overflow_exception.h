@@ -0,0 +1,28 @@
+/*********************************************************************************
+
+  * FileName:       cuckoo_hash_overflow_exception.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class CuckooHashOverflowException
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <exception>
+
+
+class CuckooHashOverflowException : public std::exception
+{
+public:
+	virtual const char* what() const throw()
+	{
+		return "The entry can never fit in the cuckoo hash map !";
+	}
+};
+
+
@@ -0,0 +1,276 @@
+/*********************************************************************************
+
+  * FileName:       hash.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the classes HashFunction, Hash and KeyEqual
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <cstring>
+#include <functional>
+#include <string>
+
+#if (__cplusplus >= 201703L) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L))
+#include <string_view>
+#define HASH_STRING_VIEW
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+
+/*
+* The mixers shared by the hash functions: every bit of the result depends on every bit of the input,
+* so that the hash codes can be masked by a power of 2 as well as taken modulo a prime
+*/
+class HashFunction
+{
+protected:
+	/*
+	* Mixes x with the finalizer of MurmurHash3
+	* @ Parameter:
+	*       x:         The given number
+	* @ Return:
+	*                  The mixed number
+	*/
+	static unsigned long long Mix(unsigned long long x);
+
+	/*
+	* Multiplies a by b into 128 bits, then folds the high half into the low half, as wyhash does
+	* @ Parameter:
+	*       a:         The multiplicand
+	*       b:         The multiplier
+	* @ Return:
+	*                  The high half ^ the low half of a * b
+	*/
+	static unsigned long long Multiply(unsigned long long a, unsigned long long b);
+
+	/*
+	* Reads 8 bytes
+	* @ Parameter:
+	*       p:         Points to the bytes
+	* @ Return:
+	*                  The bytes as a number
+	*/
+	static unsigned long long Read8(const unsigned char* p);
+
+	/*
+	* Reads 4 bytes
+	* @ Parameter:
+	*       p:         Points to the bytes
+	* @ Return:
+	*                  The bytes as a number
+	*/
+	static unsigned long long Read4(const unsigned char* p);
+
+public:
+	/*
+	* Hashes a byte string in the way of wyhash
+	* @ Parameter:
+	*       s:         Points to the bytes
+	*       n:         The number of bytes
+	* @ Return:
+	*                  The hash code
+	*/
+	static size_t HashBytes(const void* s, size_t n);
+};
+
+
+/*
+* The default hash function, integers and other keys hashed by std::hash are mixed
+*/
+template<typename K> class Hash: public HashFunction
+{
+public:
+	size_t operator()(const K& k) const { return static_cast<size_t>(Mix(static_cast<unsigned long long>(std::hash<K>()(k)))); }
+};
+
+
+/*
+* Hashes the content of the string instead of its address
+*/
+template<> class Hash<char*>: public HashFunction
+{
+public:
+	size_t operator()(const char* s) const { return HashBytes(s, strlen(s)); }
+};
+
+
+/*
+* Hashes the content of the string instead of its address
+*/
+template<> class Hash<const char*>: public HashFunction
+{
+public:
+	size_t operator()(const char* s) const { return HashBytes(s, strlen(s)); }
+};
+
+
+/*
+* Hashes the content of the string, a std::string_view or a char[] gets the same hash code
+* as the std::string it equals without constructing one
+*/
+template<> class Hash<std::string>: public HashFunction
+{
+public:
+#ifdef HASH_STRING_VIEW
+	size_t operator()(std::string_view s) const { return HashBytes(s.data(), s.size()); }
+#else
+	size_t operator()(const std::string& s) const { return HashBytes(s.data(), s.size()); }
+#endif
+};
+
+
+/*
+* The default key comparison, by ==
+*/
+template<typename K> class KeyEqual
+{
+public:
+	bool operator()(const K& a, const K& b) const { return a == b; }
+};
+
+
+/*
+* Compares the content of the strings instead of their addresses
+*/
+template<> class KeyEqual<char*>
+{
+public:
+	bool operator()(const char* a, const char* b) const { return strcmp(a, b) == 0; }
+};
+
+
+/*
+* Compares the content of the strings instead of their addresses
+*/
+template<> class KeyEqual<const char*>
+{
+public:
+	bool operator()(const char* a, const char* b) const { return strcmp(a, b) == 0; }
+};
+
+
+/*
+* Compares a std::string with anything it can be compared with by ==, such as a std::string_view
+*/
+template<> class KeyEqual<std::string>
+{
+public:
+	template<typename A, typename B> bool operator()(const A& a, const B& b) const { return a == b; }
+};
+
+
+inline unsigned long long HashFunction::Mix(unsigned long long x)
+{
+	x ^= x >> 33;
+	x *= 0xFF51AFD7ED558CCDULL;
+	x ^= x >> 33;
+	x *= 0xC4CEB9FE1A85EC53ULL;
+	x ^= x >> 33;
+
+	return x;
+}
+
+
+inline unsigned long long HashFunction::Multiply(unsigned long long a, unsigned long long b)
+{
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+	return static_cast<unsigned long long>(r >> 64) ^ static_cast<unsigned long long>(r);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long long high = 0;
+	unsigned long long low = _umul128(a, b, &high);
+	return high ^ low;
+#else
+	unsigned long long a_high = a >> 32, a_low = a & 0xFFFFFFFFULL;
+	unsigned long long b_high = b >> 32, b_low = b & 0xFFFFFFFFULL;
+	unsigned long long high_high = a_high * b_high, high_low = a_high * b_low;
+	unsigned long long low_high = a_low * b_high, low_low = a_low * b_low;
+	unsigned long long middle = (low_low >> 32) + (high_low & 0xFFFFFFFFULL) + (low_high & 0xFFFFFFFFULL);
+	unsigned long long high = high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+	unsigned long long low = (middle << 32) | (low_low & 0xFFFFFFFFULL);
+	return high ^ low;
+#endif
+}
+
+
+inline unsigned long long HashFunction::Read8(const unsigned char* p)
+{
+	unsigned long long x = 0;
+	memcpy(&x, p, 8);
+
+	return x;
+}
+
+
+inline unsigned long long HashFunction::Read4(const unsigned char* p)
+{
+	unsigned int x = 0;
+	memcpy(&x, p, 4);
+
+	return x;
+}
+
+
+inline size_t HashFunction::HashBytes(const void* s, size_t n)
+{
+	const unsigned long long SECRET[4] = { 0xA0761D6478BD642FULL, 0xE7037ED1A0B428DBULL, 0x8EBC6AF09C88C6E3ULL, 0x589965CC75374CC3ULL };
+	const unsigned char* p = static_cast<const unsigned char*>(s);
+	unsigned long long seed = Multiply(SECRET[0], SECRET[1]), a = 0, b = 0;
+
+	if (n <= 16)
+	{
+		if (n >= 4)
+		{
+			// Two overlapping 4 byte reads from each end cover 4 to 16 bytes without a loop
+			a = (Read4(p) << 32) | Read4(p + ((n >> 3) << 2));
+			b = (Read4(p + n - 4) << 32) | Read4(p + n - 4 - ((n >> 3) << 2));
+		}
+		else if (n > 0)
+			a = (static_cast<unsigned long long>(p[0]) << 16) | (static_cast<unsigned long long>(p[n >> 1]) << 8) | p[n - 1];
+	}
+	else
+	{
+		size_t i = n;
+
+		if (i > 48)
+		{
+			// Three independent lanes keep the multipliers busy on long strings
+			unsigned long long lane1 = seed, lane2 = seed;
+
+			do
+			{
+				seed = Multiply(Read8(p) ^ SECRET[1], Read8(p + 8) ^ seed);
+				lane1 = Multiply(Read8(p + 16) ^ SECRET[2], Read8(p + 24) ^ lane1);
+				lane2 = Multiply(Read8(p + 32) ^ SECRET[3], Read8(p + 40) ^ lane2);
+				p += 48;
+				i -= 48;
+			} while (i > 48);
+
+			seed ^= lane1 ^ lane2;
+		}
+
+		while (i > 16)
+		{
+			seed = Multiply(Read8(p) ^ SECRET[1], Read8(p + 8) ^ seed);
+			p += 16;
+			i -= 16;
+		}
+
+		a = Read8(p + i - 16);
+		b = Read8(p + i - 8);
+	}
+
+	return static_cast<size_t>(Multiply(SECRET[1] ^ n, Multiply(a ^ SECRET[1], b ^ seed)));
+}
+
+
@@ -15,22 +15,61 @@
 
 #include <cmath>
 #include <cstring>
+#include <utility>
 #include "dictionary.h"
 #include "entry.h"
 #include "bitmap.h"
+#include "hash.h"
+#include "hashmap_statistics.h"
 
+// Define HASHMAP_DICTIONARY_STATS to keep the probe lengths and the rehash times, see GetStats()
+#ifdef HASHMAP_DICTIONARY_STATS
+#include <chrono>
+#endif
 
-template<typename K, typename V> class HashMapDictionary: public Dictionary<K, V>
+
+/*
+* An open addressing hash map with linear probing and lazy removal,
+* keys are hashed by H and compared by E, which may also accept other types of keys for lookup,
+* such as a std::string_view for a std::string key
+*/
+template<typename K, typename V, typename H = Hash<K>, typename E = KeyEqual<K>> class HashMapDictionary: public Dictionary<K, V>
 {
 protected:
-	// Points to the buckets
-	Entry<K, V>** ht_;
+	// The hash function
+	H hash_;
+	// The key comparison
+	E equal_;
+	// The buckets, which hold the entries inline
+	Entry<K, V>* ht_;
+	// The largest capacity GetCapacity() gives, so that doubling it stays within int
+	const static int MAX_CAPACITY_ = 1 << 30;
 	// The capacity of the buckets
 	int capacity_;
+	// Whether the capacity is a power of 2, so that the home bucket is taken by masking the hash code
+	// instead of by the modulo of a prime, which needs a hash function mixing all the bits
+	bool power_of_two_;
 	// The number of entries in the buckets
 	int size_;
+	// The number of lazily removed buckets, which lengthen the search chains as entries do
+	int removed_;
 	// The lazy removal flag
 	BitMap* lazy_removal_;
+	// The occupancy flag, set for the buckets holding entries
+	BitMap* occupied_;
+#ifdef HASHMAP_DICTIONARY_STATS
+	// The probe and rehash counters
+	HashMapStatisticsRecorder stats_;
+#endif
+
+	/*
+	* Judges whether bucket x holds an entry
+	* @ Parameter:
+	*       x:         The index of the bucket
+	* @ Return:
+	*                  Whether bucket x holds an entry
+	*/
+	bool IsOccupied(int x) const;
 
 	/*
 	* Judges whether x is lazy removed
@@ -48,14 +87,52 @@ protected:
 	*/
 	void MarkAsRemoved(int x);
 
+	/*
+	* Gets the home bucket of k, where its search chain starts
+	* @ Parameter:
+	*       k:         The key, or anything H accepts in its place
+	* @ Return:
+	*                  The index of the home bucket
+	*/
+	template<typename Q> int GetHome(const Q& k) const;
+
+	/*
+	* Gets the bucket following r along the search chains
+	* @ Parameter:
+	*       r:         The index of the bucket
+	* @ Return:
+	*                  The index of the next bucket
+	*/
+	int GetNext(int r) const;
+
 	/*
 	* Searches along the search chain corresponding to k, finds the bucket that matches the entry
 	* @ Parameter:
-	*       k:         The key
+	*       k:         The key, or anything H and E accept in its place
 	* @ Return:
 	*                  The index
 	*/
-	int ProbeForHit(const K& k);
+	template<typename Q> int ProbeForHit(const Q& k);
+
+	/*
+	* Searches along the search chain corresponding to k once, finds the bucket that matches the entry,
+	* or the first bucket that can be used if there's none
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The index, the bucket is occupied only if it matches the entry
+	*/
+	int ProbeForInsert(const K& k);
+
+	/*
+	* Inserts the entry into bucket r found by ProbeForInsert(), rehashes first if the load factor would exceed the threshold
+	* @ Parameter:
+	*       r:         The index of the bucket
+	*       e:         The entry, which is moved into the bucket
+	* @ Return:
+	*                  The index of the bucket holding the entry
+	*/
+	int Insert(int r, Entry<K, V>&& e);
 
 	/*
 	* Searches along the search chain corresponding to k, finds the first bucket that can be used
@@ -67,57 +144,69 @@ protected:
 	int ProbeForFree(const K& k);
 
 	/*
-	* Expands and rehashes the buckets, ensures the load facor is below threshold
+	* Expands and rehashes the buckets, ensures the load facor is below threshold,
+	* when the lazily removed buckets outnumber the entries, cleans them up without expanding
 	*/
 	void Rehash();
 
 	/*
-	* Gets the first prime number that >= c
+	* Moves the entries into c new buckets, clears all the lazy removal flags
 	* @ Parameter:
-	*       c:         The given number
-	* @ Return:
-	*                  The first prime number that >= c
+	*       c:         The new capacity, which comes from GetCapacity()
 	*/
-	int GetPrime(int c);
+	void Resize(int c);
 
 	/*
-	* Computes the hash code
+	* Rehashes the buckets in place at the same capacity, clears all the lazy removal flags
+	*/
+	void Cleanup();
+
+	/*
+	* Gets the length of the search chain from the home bucket of the entry in bucket r to r
 	* @ Parameter:
-	*       c:         The given char
+	*       r:         The index of the bucket
 	* @ Return:
-	*                  The hash code
+	*                  The number of buckets probed to hit the entry
 	*/
-	size_t HashCode(char c);
+	int GetProbeLength(int r) const;
 
 	/*
-	* Computes the hash code
+	* Gets the first capacity that >= c, a power of 2 or a prime number, c is clamped to MAX_CAPACITY_ first
 	* @ Parameter:
-	*       c:         The given int
+	*       c:         The given number
 	* @ Return:
-	*                  The hash code
+	*                  The first capacity that >= c
 	*/
-	size_t HashCode(int k);
+	int GetCapacity(long long c);
 
 	/*
-	* Computes the hash code
+	* Gets the first prime number that >= c
 	* @ Parameter:
-	*       c:         The given long long
+	*       c:         The given number
 	* @ Return:
-	*                  The hash code
+	*                  The first prime number that >= c
+	*/
+	int GetPrime(int c);
+
+	/*
+	* Visits the entries whose home bucket is h, which all lie in the run of used buckets starting at h
+	* @ Parameter:
+	*       h:         The index of the home bucket
+	*       visit:     The function object, called with the key and the value
 	*/
-	size_t HashCode(long long i);
+	template<typename VST> void VisitHome(int h, VST& visit);
 
 	/*
-	* Computes the hash code
+	* Reverses the bits of x
 	* @ Parameter:
-	*       c:         The given char[]
+	*       x:         The given number
 	* @ Return:
-	*                  The hash code
+	*                  x with bit i moved to bit 31 - i
 	*/
-	size_t HashCode(char s[]);
+	static unsigned int ReverseBits(unsigned int x);
 
 public:
-	HashMapDictionary(int c = 11);
+	HashMapDictionary(int c = 11, bool power_of_two = false);
 	~HashMapDictionary();
 
 	/*
@@ -146,6 +235,44 @@ public:
 	*/
 	V* Get(K k);
 
+	/*
+	* Gets the value of the entry with key equal to k, without constructing a key from k
+	* @ Parameter:
+	*       k:         Anything H and E accept in place of a key
+	* @ Return:
+	*                  The value of the entry with key equal to k
+	*/
+	template<typename Q> V* Get(const Q& k);
+
+	/*
+	* Inserts an entry, or updates the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether an entry is inserted, false if the value of an entry is updated
+	*/
+	bool Upsert(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k, inserts an entry with the default value first if there's none
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k, valid until the next insertion or removal
+	*/
+	V& GetOrInsert(K k);
+
+	/*
+	* Inserts an entry whose value is constructed from a, only if there's no entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       a:         The arguments of the constructor of the value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	template<typename... A> bool TryEmplace(K k, A&&... a);
+
 	/*
 	* Removes the entry with key == k
 	* @ Parameter:
@@ -154,71 +281,307 @@ public:
 	*                  Whether removal is successful
 	*/
 	bool Remove(K k);
+
+	/*
+	* Gets the average length of the search chains of the entries
+	* @ Return:
+	*                  The average number of buckets probed to hit an entry
+	*/
+	double GetAverageProbeLength() const;
+
+	/*
+	* Gets the maximum length of the search chains of the entries
+	* @ Return:
+	*                  The maximum number of buckets probed to hit an entry
+	*/
+	int GetMaxProbeLength() const;
+
+	/*
+	* Expands the buckets once, so that n entries fit without rehashing
+	* @ Parameter:
+	*       n:         The number of entries
+	*/
+	void Reserve(int n);
+
+	/*
+	* Inserts n entries after one Reserve(), optionally hashes all the keys first
+	* and inserts them in the order of their home buckets, so that the buckets are written sequentially
+	* @ Parameter:
+	*       k:         The keys
+	*       v:         The values
+	*       n:         The number of entries
+	*       unique:    Whether the caller guarantees that the keys are distinct and not in the map yet,
+	*                  so that the search for an equal key is skipped
+	*       sorted:    Whether to insert in the order of the home buckets, which takes O(capacity) extra space
+	* @ Return:
+	*                  The number of entries inserted
+	*/
+	int BulkLoad(const K* k, const V* v, int n, bool unique = false, bool sorted = false);
+
+	/*
+	* Traverses the entries in the order of the buckets, skips the empty buckets 64 at a time
+	* @ Parameter:
+	*       visit:     The function object, called with the key and the value,
+	*                  which must not insert or remove entries
+	*/
+	template<typename VST> void Traverse(VST& visit);
+
+	/*
+	* Traverses the entries in the order of the buckets without modifying them
+	* @ Parameter:
+	*       visit:     The function object, called with the key and the value as constants
+	*/
+	template<typename VST> void Traverse(VST& visit) const;
+
+	/*
+	* Traverses the entries of the next n home buckets from the cursor, so that a traversal can be spread over many calls,
+	* an entry in the map from the first call to the last is visited at least once even if the buckets are rehashed between the calls,
+	* in the power of 2 mode the home buckets are visited in the bit-reversed order as Redis SCAN does,
+	* so that the buckets already visited stay visited when the capacity doubles,
+	* in the prime mode a change of the capacity restarts the traversal, and entries may be visited again
+	* @ Parameter:
+	*       cursor:    0 to start a traversal, otherwise the cursor returned by the last call
+	*       visit:     The function object, called with the key and the value,
+	*                  which must not insert or remove entries
+	*       n:         The number of home buckets to visit
+	* @ Return:
+	*                  The cursor for the next call, 0 if the traversal is finished
+	*/
+	template<typename VST> unsigned long long Scan(unsigned long long cursor, VST& visit, int n = 16);
+
+	/*
+	* Gets a snapshot of the load and, when HASHMAP_DICTIONARY_STATS is defined, of the probe lengths of the lookups
+	* and the times of the rehashes since the construction
+	* @ Return:
+	*                  The statistics
+	*/
+	HashMapStatistics GetStats() const;
 };
 
 
-template<typename K, typename V> bool HashMapDictionary<K, V>::IsLazilyRemoved(int x)
+template<typename K, typename V, typename H, typename E> bool HashMapDictionary<K, V, H, E>::IsOccupied(int x) const
+{
+	return occupied_->Test(x);
+}
+
+
+template<typename K, typename V, typename H, typename E> bool HashMapDictionary<K, V, H, E>::IsLazilyRemoved(int x)
 {
 	return lazy_removal_->Test(x);
 }
 
 
-template<typename K, typename V> void HashMapDictionary<K, V>::MarkAsRemoved(int x)
+template<typename K, typename V, typename H, typename E> void HashMapDictionary<K, V, H, E>::MarkAsRemoved(int x)
 {
 	lazy_removal_->Set(x);
 }
 
 
-template<typename K, typename V> int HashMapDictionary<K, V>::ProbeForHit(const K& k)
+template<typename K, typename V, typename H, typename E> template<typename Q> int HashMapDictionary<K, V, H, E>::GetHome(const Q& k) const
+{
+	if (power_of_two_ == true)
+		return static_cast<int>(hash_(k) & static_cast<size_t>(capacity_ - 1));
+
+	return static_cast<int>(hash_(k) % capacity_);
+}
+
+
+template<typename K, typename V, typename H, typename E> int HashMapDictionary<K, V, H, E>::GetNext(int r) const
+{
+	return (r + 1 == capacity_) ? 0 : r + 1;
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> int HashMapDictionary<K, V, H, E>::ProbeForHit(const Q& k)
 {
-	int r = HashCode(k) % capacity_;
+	int home = GetHome(k), r = home;
 
-	while (((ht_[r] != nullptr) && (ht_[r]->key_ != k)) || ((ht_[r] == nullptr) && (IsLazilyRemoved(r) == true)))
-		r = (r + 1) % capacity_;
+	while (((IsOccupied(r) == true) && (equal_(ht_[r].key_, k) == false)) || ((IsOccupied(r) == false) && (IsLazilyRemoved(r) == true)))
+		r = GetNext(r);
+
+#ifdef HASHMAP_DICTIONARY_STATS
+	stats_.RecordProbe(IsOccupied(r), (r - home + capacity_) % capacity_ + 1);
+#endif
 
 	return r;
 }
 
 
-template<typename K, typename V> int HashMapDictionary<K, V>::ProbeForFree(const K& k)
+template<typename K, typename V, typename H, typename E> int HashMapDictionary<K, V, H, E>::ProbeForFree(const K& k)
+{
+	int r = GetHome(k);
+
+	while (IsOccupied(r) == true)
+		r = GetNext(r);
+
+	return r;
+}
+
+
+template<typename K, typename V, typename H, typename E> int HashMapDictionary<K, V, H, E>::ProbeForInsert(const K& k)
+{
+	int home = GetHome(k), r = home, free = -1;
+
+	while ((IsOccupied(r) == true) || (IsLazilyRemoved(r) == true))
+	{
+		if (IsOccupied(r) == false)
+		{
+			if (free < 0)
+				free = r;
+		}
+		else if (equal_(ht_[r].key_, k) == true)
+			break;
+
+		r = GetNext(r);
+	}
+
+#ifdef HASHMAP_DICTIONARY_STATS
+	stats_.RecordProbe(IsOccupied(r), (r - home + capacity_) % capacity_ + 1);
+#endif
+
+	return ((IsOccupied(r) == false) && (free >= 0)) ? free : r;
+}
+
+
+template<typename K, typename V, typename H, typename E> int HashMapDictionary<K, V, H, E>::Insert(int r, Entry<K, V>&& e)
 {
-	int r = HashCode(k) % capacity_;
+	// Reusing a lazily removed bucket keeps the load factor, otherwise the search chains are rebuilt first
+	if ((IsLazilyRemoved(r) == false) && ((GetSize() + 1LL + removed_) * 2 > capacity_))
+	{
+		Rehash();
+		r = ProbeForFree(e.key_);
+	}
 
-	while (ht_[r] != nullptr)
-		r = (r + 1) % capacity_;
+	if (IsLazilyRemoved(r) == true)
+	{
+		lazy_removal_->Clear(r);
+		removed_--;
+	}
+
+	ht_[r] = std::move(e);
+	occupied_->Set(r);
+	size_++;
 
 	return r;
 }
 
 
-template<typename K, typename V> void HashMapDictionary<K, V>::Rehash()
+template<typename K, typename V, typename H, typename E> void HashMapDictionary<K, V, H, E>::Rehash()
+{
+	if (removed_ > size_)
+	{
+		Cleanup();
+		return;
+	}
+
+	Resize(GetCapacity(2LL * capacity_));
+}
+
+
+template<typename K, typename V, typename H, typename E> void HashMapDictionary<K, V, H, E>::Resize(int c)
 {
+#ifdef HASHMAP_DICTIONARY_STATS
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#endif
+
 	int old_capacity = capacity_;
-	Entry<K, V>** old_ht = ht_;
-	capacity_ = GetPrime(2 * capacity_);
-	ht_ = new Entry<K, V>*[capacity_];
-	memset(ht_, 0, capacity_ * sizeof(Entry<K, V>*));
+	Entry<K, V>* old_ht = ht_;
+	BitMap* old_occupied = occupied_;
+	capacity_ = c;
+	ht_ = new Entry<K, V>[capacity_];
+	occupied_ = new BitMap(capacity_);
 
 	delete lazy_removal_;
 	lazy_removal_ = new BitMap(capacity_);
-	size_ = 0;
+	removed_ = 0;
 
+	// The entries are all distinct, so they are moved straight into free buckets, never reallocated
 	for (int i = 0; i < old_capacity; i++)
 	{
-		if (old_ht[i] != nullptr)
+		if (old_occupied->Test(i) == true)
 		{
-			Put(old_ht[i]->key_, old_ht[i]->value_);
-			delete old_ht[i];
-			old_ht[i] = nullptr;
+			int r = ProbeForFree(old_ht[i].key_);
+			ht_[r] = std::move(old_ht[i]);
+			occupied_->Set(r);
 		}
 	}
 
 	delete[] old_ht;
 	old_ht = nullptr;
+	delete old_occupied;
+	old_occupied = nullptr;
+
+#ifdef HASHMAP_DICTIONARY_STATS
+	stats_.RecordRehash(false, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+#endif
+}
+
+
+template<typename K, typename V, typename H, typename E> void HashMapDictionary<K, V, H, E>::Cleanup()
+{
+#ifdef HASHMAP_DICTIONARY_STATS
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#endif
+
+	// Starts right after a bucket that has been empty since the last rehash, no search chain passes through it,
+	// so when bucket r is reached, every chain ending before r has been settled and cannot pass through r
+	int s = 0;
+
+	while ((s < capacity_) && ((IsOccupied(s) == true) || (IsLazilyRemoved(s) == true)))
+		s++;
+
+	delete lazy_removal_;
+	lazy_removal_ = new BitMap(capacity_);
+	removed_ = 0;
+
+	for (int i = 1; i <= capacity_; i++)
+	{
+		int r = (s + i) % capacity_;
+
+		if (IsOccupied(r) == false)
+			continue;
+
+		occupied_->Clear(r);
+		int free = ProbeForFree(ht_[r].key_);
+
+		if (free != r)
+			ht_[free] = std::move(ht_[r]);
+
+		occupied_->Set(free);
+	}
+
+#ifdef HASHMAP_DICTIONARY_STATS
+	stats_.RecordRehash(true, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+#endif
+}
+
+
+template<typename K, typename V, typename H, typename E> int HashMapDictionary<K, V, H, E>::GetProbeLength(int r) const
+{
+	int home = GetHome(ht_[r].key_);
+
+	return (r - home + capacity_) % capacity_ + 1;
 }
 
 
-template<typename K, typename V> int HashMapDictionary<K, V>::GetPrime(int c)
+template<typename K, typename V, typename H, typename E> int HashMapDictionary<K, V, H, E>::GetCapacity(long long c)
+{
+	if (c > MAX_CAPACITY_)
+		c = MAX_CAPACITY_;
+
+	if (power_of_two_ == false)
+		return GetPrime(static_cast<int>(c));
+
+	int i = 1;
+
+	while (i < c)
+		i *= 2;
+
+	return i;
+}
+
+
+template<typename K, typename V, typename H, typename E> int HashMapDictionary<K, V, H, E>::GetPrime(int c)
 {
 	int i = c, temp = 0;
 	bool found = true;
@@ -245,109 +608,292 @@ template<typename K, typename V> int HashMapDictionary<K, V>::GetPrime(int c)
 }
 
 
-template<typename K, typename V> size_t HashMapDictionary<K, V>::HashCode(char c)
+template<typename K, typename V, typename H, typename E> HashMapDictionary<K, V, H, E>::HashMapDictionary(int c, bool power_of_two)
+{
+	power_of_two_ = power_of_two;
+	capacity_ = GetCapacity(c);
+	size_ = 0;
+	removed_ = 0;
+	ht_ = new Entry<K, V>[capacity_];
+	lazy_removal_ = new BitMap(capacity_);
+	occupied_ = new BitMap(capacity_);
+}
+
+
+template<typename K, typename V, typename H, typename E> HashMapDictionary<K, V, H, E>::~HashMapDictionary()
+{
+	delete[] ht_;
+	ht_ = nullptr;
+	delete lazy_removal_;
+	lazy_removal_ = nullptr;
+	delete occupied_;
+	occupied_ = nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> int HashMapDictionary<K, V, H, E>::GetSize() const
 {
-	return static_cast<size_t>(c);
+	return size_;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool HashMapDictionary<K, V, H, E>::Put(K k, V v)
+{
+	int r = ProbeForInsert(k);
+
+	if (IsOccupied(r) == true)
+		return false;
+
+	Insert(r, Entry<K, V>(std::move(k), std::move(v)));
+
+	return true;
 }
 
 
-template<typename K, typename V> size_t HashMapDictionary<K, V>::HashCode(int k)
+template<typename K, typename V, typename H, typename E> V* HashMapDictionary<K, V, H, E>::Get(K k)
 {
-	return static_cast<size_t>(k);
+	int r = ProbeForHit(k);
+	return (IsOccupied(r) == true) ? &(ht_[r].value_) : nullptr;
 }
 
 
-template<typename K, typename V> size_t HashMapDictionary<K, V>::HashCode(long long i)
+template<typename K, typename V, typename H, typename E> template<typename Q> V* HashMapDictionary<K, V, H, E>::Get(const Q& k)
 {
-	return static_cast<size_t>((i >> 32) + static_cast<int>(i));
+	int r = ProbeForHit(k);
+	return (IsOccupied(r) == true) ? &(ht_[r].value_) : nullptr;
 }
 
 
-template<typename K, typename V> size_t HashMapDictionary<K, V>::HashCode(char s[])
+template<typename K, typename V, typename H, typename E> bool HashMapDictionary<K, V, H, E>::Upsert(K k, V v)
 {
-	unsigned int h = 0;
-	size_t n = strlen(s);
+	int r = ProbeForInsert(k);
 
-	for (size_t i = 0; i < n; i++)
+	if (IsOccupied(r) == true)
 	{
-		h = (h << 5) | (h >> 27);
-		h += static_cast<int>(s[i]);
+		ht_[r].value_ = std::move(v);
+		return false;
 	}
 
-	return static_cast<size_t>(h);
+	Insert(r, Entry<K, V>(std::move(k), std::move(v)));
+
+	return true;
 }
 
 
-template<typename K, typename V> HashMapDictionary<K, V>::HashMapDictionary(int c)
+template<typename K, typename V, typename H, typename E> V& HashMapDictionary<K, V, H, E>::GetOrInsert(K k)
 {
-	capacity_ = GetPrime(c);
-	size_ = 0;
-	ht_ = new Entry<K, V>*[capacity_];
-	memset(ht_, 0, capacity_ * sizeof(Entry<K, V>*));
-	lazy_removal_ = new BitMap(capacity_);
+	int r = ProbeForInsert(k);
+
+	if (IsOccupied(r) == false)
+		r = Insert(r, Entry<K, V>(std::move(k), V()));
+
+	return ht_[r].value_;
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename... A> bool HashMapDictionary<K, V, H, E>::TryEmplace(K k, A&&... a)
+{
+	int r = ProbeForInsert(k);
+
+	if (IsOccupied(r) == true)
+		return false;
+
+	Insert(r, Entry<K, V>(std::move(k), V(std::forward<A>(a)...)));
+
+	return true;
 }
 
 
-template<typename K, typename V> HashMapDictionary<K, V>::~HashMapDictionary()
+template<typename K, typename V, typename H, typename E> bool HashMapDictionary<K, V, H, E>::Remove(K k)
 {
+	int r = ProbeForHit(k);
+
+	if (IsOccupied(r) == false)
+		return false;
+
+	// Releases what the key and the value hold, the bucket itself is kept
+	ht_[r] = Entry<K, V>();
+	occupied_->Clear(r);
+	MarkAsRemoved(r);
+	size_--;
+	removed_++;
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> double HashMapDictionary<K, V, H, E>::GetAverageProbeLength() const
+{
+	if (GetSize() == 0)
+		return 0.0;
+
+	long long total = 0;
+
+	for (int i = 0; i < capacity_; i++)
+		if (IsOccupied(i) == true)
+			total += GetProbeLength(i);
+
+	return static_cast<double>(total) / GetSize();
+}
+
+
+template<typename K, typename V, typename H, typename E> int HashMapDictionary<K, V, H, E>::GetMaxProbeLength() const
+{
+	int max = 0;
+
 	for (int i = 0; i < capacity_; i++)
+		if ((IsOccupied(i) == true) && (GetProbeLength(i) > max))
+			max = GetProbeLength(i);
+
+	return max;
+}
+
+
+template<typename K, typename V, typename H, typename E> void HashMapDictionary<K, V, H, E>::Reserve(int n)
+{
+	// Insert() rehashes once (size + removed) * 2 exceeds the capacity
+	if ((static_cast<long long>(n) + removed_) * 2 <= capacity_)
+		return;
+
+	int c = GetCapacity(2LL * n);
+	Resize((c > capacity_) ? c : capacity_);
+}
+
+
+template<typename K, typename V, typename H, typename E> int HashMapDictionary<K, V, H, E>::BulkLoad(const K* k, const V* v, int n, bool unique, bool sorted)
+{
+	if (n <= 0)
+		return 0;
+
+	Reserve(GetSize() + n);
+
+	int* order = new int[n];
+
+	for (int i = 0; i < n; i++)
+		order[i] = i;
+
+	// Counting sort by the home buckets, stable so that the first of equal keys is the one inserted
+	if (sorted == true)
 	{
-		if (ht_[i] != nullptr)
+		int* home = new int[n];
+		int* count = new int[capacity_ + 1];
+		memset(count, 0, (capacity_ + 1) * sizeof(int));
+
+		for (int i = 0; i < n; i++)
 		{
-			delete ht_[i];
-			ht_[i] = nullptr;
+			home[i] = GetHome(k[i]);
+			count[home[i] + 1]++;
 		}
+
+		for (int i = 0; i < capacity_; i++)
+			count[i + 1] += count[i];
+
+		for (int i = 0; i < n; i++)
+			order[count[home[i]]++] = i;
+
+		delete[] count;
+		count = nullptr;
+		delete[] home;
+		home = nullptr;
 	}
 
-	delete[] ht_;
-	ht_ = nullptr;
-	delete lazy_removal_;
-	lazy_removal_ = nullptr;
+	int inserted = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		int r = (unique == true) ? ProbeForFree(k[order[i]]) : ProbeForInsert(k[order[i]]);
+
+		if (IsOccupied(r) == true)
+			continue;
+
+		Insert(r, Entry<K, V>(k[order[i]], v[order[i]]));
+		inserted++;
+	}
+
+	delete[] order;
+	order = nullptr;
+
+	return inserted;
 }
 
 
-template<typename K, typename V> int HashMapDictionary<K, V>::GetSize() const
+template<typename K, typename V, typename H, typename E> template<typename VST> void HashMapDictionary<K, V, H, E>::VisitHome(int h, VST& visit)
 {
-	return size_;
+	// A search chain never crosses an empty bucket, so neither does the run holding the entries of home bucket h
+	for (int r = h; (IsOccupied(r) == true) || (IsLazilyRemoved(r) == true); r = GetNext(r))
+		if ((IsOccupied(r) == true) && (GetHome(ht_[r].key_) == h))
+			visit(ht_[r].key_, ht_[r].value_);
 }
 
 
-template<typename K, typename V> bool HashMapDictionary<K, V>::Put(K k, V v)
+template<typename K, typename V, typename H, typename E> template<typename VST> void HashMapDictionary<K, V, H, E>::Traverse(VST& visit) const
 {
-	if (ht_[ProbeForHit(k)] != nullptr)
-		return false;
+	for (int r = occupied_->FindNextSet(0); (r >= 0) && (r < capacity_); r = occupied_->FindNextSet(r + 1))
+		visit(static_cast<const K&>(ht_[r].key_), static_cast<const V&>(ht_[r].value_));
+}
 
-	int r = ProbeForFree(k);
-	ht_[r] = new Entry<K, V>(k, v);
-	size_++;
 
-	if (GetSize() * 2 > capacity_)
-		Rehash();
+template<typename K, typename V, typename H, typename E> unsigned int HashMapDictionary<K, V, H, E>::ReverseBits(unsigned int x)
+{
+	x = ((x >> 1) & 0x55555555U) | ((x & 0x55555555U) << 1);
+	x = ((x >> 2) & 0x33333333U) | ((x & 0x33333333U) << 2);
+	x = ((x >> 4) & 0x0F0F0F0FU) | ((x & 0x0F0F0F0FU) << 4);
+	x = ((x >> 8) & 0x00FF00FFU) | ((x & 0x00FF00FFU) << 8);
 
-	return true;
+	return (x >> 16) | (x << 16);
 }
 
 
-template<typename K, typename V> V* HashMapDictionary<K, V>::Get(K k)
+template<typename K, typename V, typename H, typename E> template<typename VST> void HashMapDictionary<K, V, H, E>::Traverse(VST& visit)
 {
-	int r = ProbeForHit(k);
-	return (ht_[r] != nullptr) ? &(ht_[r]->value_) : nullptr;
+	for (int r = occupied_->FindNextSet(0); (r >= 0) && (r < capacity_); r = occupied_->FindNextSet(r + 1))
+		visit(ht_[r].key_, ht_[r].value_);
 }
 
 
-template<typename K, typename V> bool HashMapDictionary<K, V>::Remove(K k)
+template<typename K, typename V, typename H, typename E> template<typename VST> unsigned long long HashMapDictionary<K, V, H, E>::Scan(unsigned long long cursor, VST& visit, int n)
 {
-	int r = ProbeForHit(k);
+	if (power_of_two_ == true)
+	{
+		// The cursor counts up from its high bits, the bits above the mask are set first so that the carry passes over them
+		unsigned int v = static_cast<unsigned int>(cursor), mask = static_cast<unsigned int>(capacity_ - 1);
 
-	if (ht_[r] == nullptr)
-		return false;
+		for (int i = 0; i < n; i++)
+		{
+			VisitHome(static_cast<int>(v & mask), visit);
+			v |= ~mask;
+			v = ReverseBits(ReverseBits(v) + 1);
 
-	delete ht_[r];
-	ht_[r] = nullptr;
-	MarkAsRemoved(r);
-	size_--;
+			if (v == 0)
+				return 0;
+		}
 
-	return true;
+		return v;
+	}
+
+	// In the prime mode the cursor holds the capacity in its high half and the next home bucket in its low half
+	int h = (static_cast<int>(cursor >> 32) == capacity_) ? static_cast<int>(cursor & 0xFFFFFFFFULL) : 0;
+
+	for (int i = 0; (i < n) && (h < capacity_); i++, h++)
+		VisitHome(h, visit);
+
+	return (h == capacity_) ? 0 : ((static_cast<unsigned long long>(capacity_) << 32) | static_cast<unsigned long long>(h));
+}
+
+
+template<typename K, typename V, typename H, typename E> HashMapStatistics HashMapDictionary<K, V, H, E>::GetStats() const
+{
+#ifdef HASHMAP_DICTIONARY_STATS
+	HashMapStatistics stats = stats_.GetSnapshot();
+#else
+	HashMapStatistics stats;
+#endif
+
+	stats.capacity_ = capacity_;
+	stats.size_ = size_;
+	stats.removed_ = removed_;
+
+	return stats;
 }
 
 
@@ -0,0 +1,153 @@
+/*********************************************************************************
+
+  * FileName:       hashmap_statistics.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class HashMapStatistics
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <atomic>
+
+
+/*
+* A snapshot of the load and the probe statistics of a hash map,
+* the counters are only kept when HASHMAP_DICTIONARY_STATS is defined, otherwise they stay 0
+*/
+class HashMapStatistics
+{
+public:
+	// The number of slots in the histograms, the last one counts all the longer probes
+	const static int HISTOGRAM_SIZE_ = 32;
+	// The capacity of the buckets
+	int capacity_;
+	// The number of entries
+	int size_;
+	// The number of lazily removed buckets
+	int removed_;
+	// The number of lookups that hit, by the number of buckets probed - 1
+	long long hit_probes_[HISTOGRAM_SIZE_];
+	// The number of lookups that missed, by the number of buckets probed - 1
+	long long miss_probes_[HISTOGRAM_SIZE_];
+	// The number of times the buckets are moved into new ones
+	long long rehashes_;
+	// The number of times the lazily removed buckets are cleaned up in place
+	long long cleanups_;
+	// The total time of the rehashes and the cleanups, in nanoseconds
+	long long rehash_time_;
+	// The longest time of a rehash or a cleanup, in nanoseconds
+	long long max_rehash_time_;
+
+	HashMapStatistics(): capacity_(0), size_(0), removed_(0), rehashes_(0), cleanups_(0), rehash_time_(0), max_rehash_time_(0)
+	{
+		for (int i = 0; i < HISTOGRAM_SIZE_; i++)
+			hit_probes_[i] = miss_probes_[i] = 0;
+	}
+
+	/*
+	* Gets the load factor, counting the lazily removed buckets, which lengthen the search chains as entries do
+	* @ Return:
+	*                  (size + removed) / capacity
+	*/
+	double GetLoadFactor() const { return (capacity_ > 0) ? static_cast<double>(size_ + removed_) / capacity_ : 0.0; }
+};
+
+
+/*
+* The counters behind HashMapStatistics, kept by a hash map when HASHMAP_DICTIONARY_STATS is defined,
+* every counter is a relaxed atomic, since lookups record their probes even when they run together under a shared lock,
+* as in ConcurrentHashMap
+*/
+class HashMapStatisticsRecorder
+{
+protected:
+	// The number of lookups that hit, by the number of buckets probed - 1
+	std::atomic<long long> hit_probes_[HashMapStatistics::HISTOGRAM_SIZE_];
+	// The number of lookups that missed, by the number of buckets probed - 1
+	std::atomic<long long> miss_probes_[HashMapStatistics::HISTOGRAM_SIZE_];
+	// The number of times the buckets are moved into new ones
+	std::atomic<long long> rehashes_;
+	// The number of times the lazily removed buckets are cleaned up in place
+	std::atomic<long long> cleanups_;
+	// The total time of the rehashes and the cleanups, in nanoseconds
+	std::atomic<long long> rehash_time_;
+	// The longest time of a rehash or a cleanup, in nanoseconds
+	std::atomic<long long> max_rehash_time_;
+
+public:
+	HashMapStatisticsRecorder(): rehashes_(0), cleanups_(0), rehash_time_(0), max_rehash_time_(0)
+	{
+		for (int i = 0; i < HashMapStatistics::HISTOGRAM_SIZE_; i++)
+		{
+			hit_probes_[i].store(0, std::memory_order_relaxed);
+			miss_probes_[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/*
+	* Records a lookup
+	* @ Parameter:
+	*       hit:       Whether the lookup hit
+	*       length:    The number of buckets probed
+	*/
+	void RecordProbe(bool hit, int length)
+	{
+		int i = (length - 1 < HashMapStatistics::HISTOGRAM_SIZE_ - 1) ? length - 1 : HashMapStatistics::HISTOGRAM_SIZE_ - 1;
+
+		if (hit == true)
+			hit_probes_[i].fetch_add(1, std::memory_order_relaxed);
+		else
+			miss_probes_[i].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/*
+	* Records a rehash or a cleanup
+	* @ Parameter:
+	*       cleanup:   Whether it is a cleanup in place
+	*       time:      The time it takes, in nanoseconds
+	*/
+	void RecordRehash(bool cleanup, long long time)
+	{
+		if (cleanup == true)
+			cleanups_.fetch_add(1, std::memory_order_relaxed);
+		else
+			rehashes_.fetch_add(1, std::memory_order_relaxed);
+
+		rehash_time_.fetch_add(time, std::memory_order_relaxed);
+
+		long long max = max_rehash_time_.load(std::memory_order_relaxed);
+
+		while ((time > max) && (max_rehash_time_.compare_exchange_weak(max, time, std::memory_order_relaxed) == false));
+	}
+
+	/*
+	* Copies the counters, each counter is read once, so that the copy may mix the counts of the lookups running meanwhile
+	* @ Return:
+	*                  The statistics, without the load
+	*/
+	HashMapStatistics GetSnapshot() const
+	{
+		HashMapStatistics stats;
+
+		for (int i = 0; i < HashMapStatistics::HISTOGRAM_SIZE_; i++)
+		{
+			stats.hit_probes_[i] = hit_probes_[i].load(std::memory_order_relaxed);
+			stats.miss_probes_[i] = miss_probes_[i].load(std::memory_order_relaxed);
+		}
+
+		stats.rehashes_ = rehashes_.load(std::memory_order_relaxed);
+		stats.cleanups_ = cleanups_.load(std::memory_order_relaxed);
+		stats.rehash_time_ = rehash_time_.load(std::memory_order_relaxed);
+		stats.max_rehash_time_ = max_rehash_time_.load(std::memory_order_relaxed);
+
+		return stats;
+	}
+};
+
+
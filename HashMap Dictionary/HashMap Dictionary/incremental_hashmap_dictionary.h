@@ -0,0 +1,486 @@
+/*********************************************************************************
+
+  * FileName:       incremental_hashmap_dictionary.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class IncrementalHashMapDictionary
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <utility>
+#include "hashmap_dictionary.h"
+
+
+/*
+* The incremental rehash mode of HashMapDictionary: crossing the threshold only allocates the new buckets,
+* the old buckets stay live and every following operation migrates a few of them,
+* so that no single operation pays for the whole table, searches consult both until the migration completes
+*/
+template<typename K, typename V, typename H = Hash<K>, typename E = KeyEqual<K>> class IncrementalHashMapDictionary: public HashMapDictionary<K, V, H, E>
+{
+protected:
+	// The number of old buckets migrated by each operation, enough to finish before the new buckets fill up
+	const static int MIGRATION_STEP_ = 8;
+	// The old buckets being migrated, or nullptr if there's no migration
+	Entry<K, V>* old_ht_;
+	// The capacity of the old buckets
+	int old_capacity_;
+	// The lazy removal flag of the old buckets, migrated buckets are marked so that search chains pass them
+	BitMap* old_lazy_removal_;
+	// The occupancy flag of the old buckets
+	BitMap* old_occupied_;
+	// The number of old buckets migrated
+	int migrated_;
+
+	/*
+	* Gets the home bucket of k among the old buckets
+	* @ Parameter:
+	*       k:         The key, or anything H accepts in its place
+	* @ Return:
+	*                  The index of the home bucket
+	*/
+	template<typename Q> int GetOldHome(const Q& k) const;
+
+	/*
+	* Searches along the search chain corresponding to k among the old buckets
+	* @ Parameter:
+	*       k:         The key, or anything H and E accept in its place
+	* @ Return:
+	*                  The index, or -1 if there's no migration or no old entry with key == k
+	*/
+	template<typename Q> int ProbeOld(const Q& k);
+
+	/*
+	* Moves the next MIGRATION_STEP_ old buckets into the buckets, releases the old buckets when all are moved
+	*/
+	void Migrate();
+
+	/*
+	* Inserts the entry into bucket r found by ProbeForInsert(), starts a migration afterwards if the load factor exceeds the threshold
+	* @ Parameter:
+	*       r:         The index of the bucket
+	*       e:         The entry, which is moved into the bucket
+	* @ Return:
+	*                  Points to the value of the entry, which stays in place when the buckets become the old buckets
+	*/
+	V* Insert(int r, Entry<K, V>&& e);
+
+	/*
+	* Starts migrating into new buckets of twice the capacity, or of the same capacity
+	* when the lazily removed buckets outnumber the entries, a previous migration is finished first
+	*/
+	void Rehash();
+
+public:
+	IncrementalHashMapDictionary(int c = 11, bool power_of_two = false);
+	~IncrementalHashMapDictionary();
+
+	/*
+	* Inserts an entry
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	bool Put(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k
+	*/
+	V* Get(K k);
+
+	/*
+	* Gets the value of the entry with key equal to k, without constructing a key from k
+	* @ Parameter:
+	*       k:         Anything H and E accept in place of a key
+	* @ Return:
+	*                  The value of the entry with key equal to k
+	*/
+	template<typename Q> V* Get(const Q& k);
+
+	/*
+	* Inserts an entry, or updates the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether an entry is inserted, false if the value of an entry is updated
+	*/
+	bool Upsert(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k, inserts an entry with the default value first if there's none
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k, valid until the next operation, which may migrate it
+	*/
+	V& GetOrInsert(K k);
+
+	/*
+	* Inserts an entry whose value is constructed from a, only if there's no entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       a:         The arguments of the constructor of the value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	template<typename... A> bool TryEmplace(K k, A&&... a);
+
+	/*
+	* Removes the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  Whether removal is successful
+	*/
+	bool Remove(K k);
+
+	/*
+	* Whether old buckets are being migrated
+	* @ Return:
+	*                  Whether old buckets are being migrated
+	*/
+	bool IsMigrating() const;
+
+	/*
+	* Finishes the migration, then expands the buckets once, so that n entries fit without rehashing
+	* @ Parameter:
+	*       n:         The number of entries
+	*/
+	void Reserve(int n);
+
+	/*
+	* Finishes the migration, then inserts n entries as HashMapDictionary::BulkLoad() does
+	* @ Parameter:
+	*       k:         The keys
+	*       v:         The values
+	*       n:         The number of entries
+	*       unique:    Whether the caller guarantees that the keys are distinct and not in the map yet
+	*       sorted:    Whether to insert in the order of the home buckets
+	* @ Return:
+	*                  The number of entries inserted
+	*/
+	int BulkLoad(const K* k, const V* v, int n, bool unique = false, bool sorted = false);
+
+	/*
+	* Traverses the entries of the new buckets, then those of the old buckets not migrated yet
+	* @ Parameter:
+	*       visit:     The function object, called with the key and the value,
+	*                  which must not insert or remove entries
+	*/
+	template<typename VST> void Traverse(VST& visit);
+
+	/*
+	* Finishes the migration, then traverses the entries of the next n home buckets as HashMapDictionary::Scan() does
+	* @ Parameter:
+	*       cursor:    0 to start a traversal, otherwise the cursor returned by the last call
+	*       visit:     The function object, called with the key and the value,
+	*                  which must not insert or remove entries
+	*       n:         The number of home buckets to visit
+	* @ Return:
+	*                  The cursor for the next call, 0 if the traversal is finished
+	*/
+	template<typename VST> unsigned long long Scan(unsigned long long cursor, VST& visit, int n = 16);
+};
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> int IncrementalHashMapDictionary<K, V, H, E>::GetOldHome(const Q& k) const
+{
+	if (this->power_of_two_ == true)
+		return static_cast<int>(this->hash_(k) & static_cast<size_t>(old_capacity_ - 1));
+
+	return static_cast<int>(this->hash_(k) % old_capacity_);
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> int IncrementalHashMapDictionary<K, V, H, E>::ProbeOld(const Q& k)
+{
+	if (old_ht_ == nullptr)
+		return -1;
+
+	// Migration only turns entries into lazily removed buckets, so the empty buckets still end every search chain
+	int r = GetOldHome(k);
+
+	while ((old_occupied_->Test(r) == true) || (old_lazy_removal_->Test(r) == true))
+	{
+		if ((old_occupied_->Test(r) == true) && (this->equal_(old_ht_[r].key_, k) == true))
+			return r;
+
+		r = (r + 1 == old_capacity_) ? 0 : r + 1;
+	}
+
+	return -1;
+}
+
+
+template<typename K, typename V, typename H, typename E> void IncrementalHashMapDictionary<K, V, H, E>::Migrate()
+{
+	if (old_ht_ == nullptr)
+		return;
+
+	for (int i = 0; (i < MIGRATION_STEP_) && (migrated_ < old_capacity_); i++, migrated_++)
+	{
+		if (old_occupied_->Test(migrated_) == false)
+			continue;
+
+		// The keys are all distinct, so the entry goes straight into a free bucket
+		int r = this->ProbeForFree(old_ht_[migrated_].key_);
+
+		if (this->IsLazilyRemoved(r) == true)
+		{
+			this->lazy_removal_->Clear(r);
+			this->removed_--;
+		}
+
+		this->ht_[r] = std::move(old_ht_[migrated_]);
+		this->occupied_->Set(r);
+		old_occupied_->Clear(migrated_);
+		old_lazy_removal_->Set(migrated_);
+	}
+
+	if (migrated_ < old_capacity_)
+		return;
+
+	delete[] old_ht_;
+	old_ht_ = nullptr;
+	delete old_lazy_removal_;
+	old_lazy_removal_ = nullptr;
+	delete old_occupied_;
+	old_occupied_ = nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> V* IncrementalHashMapDictionary<K, V, H, E>::Insert(int r, Entry<K, V>&& e)
+{
+	if (this->IsLazilyRemoved(r) == true)
+	{
+		this->lazy_removal_->Clear(r);
+		this->removed_--;
+	}
+
+	this->ht_[r] = std::move(e);
+	this->occupied_->Set(r);
+	this->size_++;
+
+	Entry<K, V>* ht = this->ht_;
+
+	if ((static_cast<long long>(this->GetSize()) + this->removed_) * 2 > this->capacity_)
+		Rehash();
+
+	return &(ht[r].value_);
+}
+
+
+template<typename K, typename V, typename H, typename E> void IncrementalHashMapDictionary<K, V, H, E>::Rehash()
+{
+#ifdef HASHMAP_DICTIONARY_STATS
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#endif
+
+	// Only reached when inserting much faster than migrating, which a small MIGRATION_STEP_ could cause
+	while (old_ht_ != nullptr)
+		Migrate();
+
+	old_ht_ = this->ht_;
+	old_capacity_ = this->capacity_;
+	old_lazy_removal_ = this->lazy_removal_;
+	old_occupied_ = this->occupied_;
+	migrated_ = 0;
+
+	if (this->removed_ <= this->GetSize())
+		this->capacity_ = this->GetCapacity(2LL * this->capacity_);
+
+	this->ht_ = new Entry<K, V>[this->capacity_];
+	this->lazy_removal_ = new BitMap(this->capacity_);
+	this->occupied_ = new BitMap(this->capacity_);
+	this->removed_ = 0;
+
+	// Only the switch to the new buckets is timed, the migration is spread over the following operations
+#ifdef HASHMAP_DICTIONARY_STATS
+	this->stats_.RecordRehash(false, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+#endif
+}
+
+
+template<typename K, typename V, typename H, typename E> IncrementalHashMapDictionary<K, V, H, E>::IncrementalHashMapDictionary(int c, bool power_of_two):
+	HashMapDictionary<K, V, H, E>(c, power_of_two), old_ht_(nullptr), old_capacity_(0), old_lazy_removal_(nullptr), old_occupied_(nullptr), migrated_(0)
+{
+}
+
+
+template<typename K, typename V, typename H, typename E> IncrementalHashMapDictionary<K, V, H, E>::~IncrementalHashMapDictionary()
+{
+	delete[] old_ht_;
+	old_ht_ = nullptr;
+	delete old_lazy_removal_;
+	old_lazy_removal_ = nullptr;
+	delete old_occupied_;
+	old_occupied_ = nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool IncrementalHashMapDictionary<K, V, H, E>::Put(K k, V v)
+{
+	Migrate();
+
+	int r = this->ProbeForInsert(k);
+
+	if ((this->IsOccupied(r) == true) || (ProbeOld(k) >= 0))
+		return false;
+
+	Insert(r, Entry<K, V>(std::move(k), std::move(v)));
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> V* IncrementalHashMapDictionary<K, V, H, E>::Get(K k)
+{
+	return Get<K>(k);
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> V* IncrementalHashMapDictionary<K, V, H, E>::Get(const Q& k)
+{
+	Migrate();
+
+	int r = this->ProbeForHit(k);
+
+	if (this->IsOccupied(r) == true)
+		return &(this->ht_[r].value_);
+
+	r = ProbeOld(k);
+
+	return (r >= 0) ? &(old_ht_[r].value_) : nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool IncrementalHashMapDictionary<K, V, H, E>::Upsert(K k, V v)
+{
+	Migrate();
+
+	int r = this->ProbeForInsert(k), old = -1;
+
+	if (this->IsOccupied(r) == true)
+		this->ht_[r].value_ = std::move(v);
+	else if ((old = ProbeOld(k)) >= 0)
+		old_ht_[old].value_ = std::move(v);
+	else
+	{
+		Insert(r, Entry<K, V>(std::move(k), std::move(v)));
+		return true;
+	}
+
+	return false;
+}
+
+
+template<typename K, typename V, typename H, typename E> V& IncrementalHashMapDictionary<K, V, H, E>::GetOrInsert(K k)
+{
+	Migrate();
+
+	int r = this->ProbeForInsert(k), old = -1;
+
+	if (this->IsOccupied(r) == true)
+		return this->ht_[r].value_;
+
+	if ((old = ProbeOld(k)) >= 0)
+		return old_ht_[old].value_;
+
+	return *Insert(r, Entry<K, V>(std::move(k), V()));
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename... A> bool IncrementalHashMapDictionary<K, V, H, E>::TryEmplace(K k, A&&... a)
+{
+	Migrate();
+
+	int r = this->ProbeForInsert(k);
+
+	if ((this->IsOccupied(r) == true) || (ProbeOld(k) >= 0))
+		return false;
+
+	Insert(r, Entry<K, V>(std::move(k), V(std::forward<A>(a)...)));
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool IncrementalHashMapDictionary<K, V, H, E>::Remove(K k)
+{
+	Migrate();
+
+	if (HashMapDictionary<K, V, H, E>::Remove(k) == true)
+		return true;
+
+	int r = ProbeOld(k);
+
+	if (r < 0)
+		return false;
+
+	old_ht_[r] = Entry<K, V>();
+	old_occupied_->Clear(r);
+	old_lazy_removal_->Set(r);
+	this->size_--;
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool IncrementalHashMapDictionary<K, V, H, E>::IsMigrating() const
+{
+	return old_ht_ != nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> void IncrementalHashMapDictionary<K, V, H, E>::Reserve(int n)
+{
+	while (old_ht_ != nullptr)
+		Migrate();
+
+	HashMapDictionary<K, V, H, E>::Reserve(n);
+}
+
+
+template<typename K, typename V, typename H, typename E> int IncrementalHashMapDictionary<K, V, H, E>::BulkLoad(const K* k, const V* v, int n, bool unique, bool sorted)
+{
+	while (old_ht_ != nullptr)
+		Migrate();
+
+	return HashMapDictionary<K, V, H, E>::BulkLoad(k, v, n, unique, sorted);
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename VST> void IncrementalHashMapDictionary<K, V, H, E>::Traverse(VST& visit)
+{
+	HashMapDictionary<K, V, H, E>::Traverse(visit);
+
+	if (old_ht_ == nullptr)
+		return;
+
+	for (int r = old_occupied_->FindNextSet(migrated_); (r >= 0) && (r < old_capacity_); r = old_occupied_->FindNextSet(r + 1))
+		visit(old_ht_[r].key_, old_ht_[r].value_);
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename VST> unsigned long long IncrementalHashMapDictionary<K, V, H, E>::Scan(unsigned long long cursor, VST& visit, int n)
+{
+	while (old_ht_ != nullptr)
+		Migrate();
+
+	return HashMapDictionary<K, V, H, E>::Scan(cursor, visit, n);
+}
+
+
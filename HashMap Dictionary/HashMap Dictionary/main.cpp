@@ -1,5 +1,9 @@
 #include <iostream>
+#include "bitmap.h"
 #include "hashmap_dictionary.h"
+#include "incremental_hashmap_dictionary.h"
+#include "perfect_hash_dictionary.h"
+#include "bitmap_index_out_of_bounds_exception.h"
 
 
 int main()
@@ -21,6 +25,31 @@ int main()
 
 	std::cout << dict.GetSize() << '\n';
 
+	BitMap bitmap;
+
+	bitmap.Set(3);
+	bitmap.Set(1000);
+	std::cout << bitmap.Test(1000) << ' ' << bitmap.Test(999) << ' ' << bitmap.Count() << '\n';
+
+	try
+	{
+		bitmap.Set(0x7FFFFFFF);
+	}
+	catch (BitMapIndexOutOfBoundsException& e)
+	{
+		std::cout << e.what() << '\n';
+	}
+
+	IncrementalHashMapDictionary<int, int> incremental;
+	PerfectHashDictionary<int, int> perfect;
+
+	// Builds in the middle of a migration, so that some of the entries are still in the old buckets
+	for (int i = 0; (i < 1000) && ((i < 100) || (incremental.IsMigrating() == false)); i++)
+		incremental.Put(i, i * 2);
+
+	std::cout << incremental.IsMigrating() << ' ' << perfect.Build(incremental) << ' ' << (perfect.GetSize() == incremental.GetSize()) << '\n';
+	std::cout << *(perfect.Get(0)) << ' ' << *(perfect.Get(99)) << '\n';
+
 	return 0;
 }
 
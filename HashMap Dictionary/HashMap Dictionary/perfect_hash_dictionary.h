@@ -0,0 +1,462 @@
+/*********************************************************************************
+
+  * FileName:       perfect_hash_dictionary.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class PerfectHashDictionary
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <algorithm>
+#include <fstream>
+#include <type_traits>
+#include <utility>
+#include "entry.h"
+#include "bitmap.h"
+#include "hash.h"
+#include "hashmap_dictionary.h"
+
+
+/*
+* A read-only hash map over a fixed set of keys, built with a minimal perfect hash in the way of PTHash:
+* the keys are split into small groups by their hash codes, and every group gets a pilot,
+* found by trying 0, 1, 2, ..., which sends all the keys of the group to free slots,
+* so that the n entries fill exactly n slots, and a lookup reads the pilot of its group and then a single slot,
+* the groups are placed from the largest, while most of the slots are still free
+*/
+template<typename K, typename V, typename H = Hash<K>, typename E = KeyEqual<K>> class PerfectHashDictionary
+{
+protected:
+	// The average number of keys in a group
+	const static int GROUP_SIZE_ = 4;
+	// The number of pilots tried for a group of several keys before the build restarts with another seed,
+	// a single key is always placed at last, as it only needs one of the free slots
+	const static int MAX_PILOT_ = 1 << 20;
+	// The number of seeds tried before the build fails
+	const static int MAX_SEED_ = 16;
+	// The tag at the start of a saved dictionary
+	const static unsigned int MAGIC_ = 0x44485050U;
+	// The hash function
+	H hash_;
+	// The key comparison
+	E equal_;
+	// The slots, one per entry
+	Entry<K, V>* slot_;
+	// The number of entries
+	int size_;
+	// The pilots of the groups
+	unsigned int* pilot_;
+	// The number of groups
+	int groups_;
+	// The seed mixed into the hash codes
+	unsigned long long seed_;
+
+	/*
+	* Mixes the hash code of k with the seed
+	* @ Parameter:
+	*       k:         The key, or anything H accepts in its place
+	* @ Return:
+	*                  The mixed hash code
+	*/
+	template<typename Q> unsigned long long GetCode(const Q& k) const;
+
+	/*
+	* Gets the group of a mixed hash code, by its high 32 bits
+	* @ Parameter:
+	*       c:         The mixed hash code
+	* @ Return:
+	*                  The index of the group
+	*/
+	int GetGroup(unsigned long long c) const;
+
+	/*
+	* Gets the slot of a mixed hash code under a pilot
+	* @ Parameter:
+	*       c:         The mixed hash code
+	*       p:         The pilot of its group
+	* @ Return:
+	*                  The index of the slot
+	*/
+	int GetSlot(unsigned long long c, unsigned int p) const;
+
+	/*
+	* Searches the pilots of all the groups for the current seed
+	* @ Parameter:
+	*       code:      The mixed hash codes of the keys
+	*       slot:      Receives the slot of every key
+	* @ Return:
+	*                  Whether every group gets a pilot
+	*/
+	bool SearchPilots(const unsigned long long* code, int* slot);
+
+	/*
+	* Frees the slots and the pilots
+	*/
+	void Release();
+
+public:
+	PerfectHashDictionary();
+	~PerfectHashDictionary();
+
+	/*
+	* Builds the dictionary from the entries of a hash map, replacing the entries it holds,
+	* the map is traversed through its own Traverse(), so that an IncrementalHashMapDictionary in the middle of a migration
+	* also gives the entries of its old buckets
+	* @ Parameter:
+	*       d:         The hash map, a HashMapDictionary or a class derived from it
+	* @ Return:
+	*                  Whether the build is successful, false if two keys have the same hash code,
+	*                  which no pilot can separate
+	*/
+	template<typename D> bool Build(D& d);
+
+	/*
+	* Gets the number of entries
+	* @ Return:
+	*                  The number of entries
+	*/
+	int GetSize() const;
+
+	/*
+	* Gets the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key, or anything H and E accept in its place
+	* @ Return:
+	*                  The value of the entry with key == k, nullptr if there's none
+	*/
+	template<typename Q> V* Get(const Q& k);
+
+	/*
+	* Gets the number of bytes the pilots take
+	* @ Return:
+	*                  The number of bytes
+	*/
+	int GetPilotBytes() const;
+
+	/*
+	* Traverses the entries in the order of the slots
+	* @ Parameter:
+	*       visit:     The function object, called with the key and the value
+	*/
+	template<typename VST> void Traverse(VST& visit);
+
+	/*
+	* Writes the dictionary to a file, for keys and values that can be copied byte by byte
+	* @ Parameter:
+	*       path:      The path of the file
+	* @ Return:
+	*                  Whether the file is written
+	*/
+	bool Save(const char* path) const;
+
+	/*
+	* Reads a dictionary written by Save(), replacing the entries it holds,
+	* the hash function must give the same hash codes as in the process that saved it
+	* @ Parameter:
+	*       path:      The path of the file
+	* @ Return:
+	*                  Whether the file is read, false if it is missing or not saved with the same K and V
+	*/
+	bool Load(const char* path);
+};
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> unsigned long long PerfectHashDictionary<K, V, H, E>::GetCode(const Q& k) const
+{
+	unsigned long long c = (static_cast<unsigned long long>(hash_(k)) ^ seed_) * 0x9E3779B97F4A7C15ULL;
+
+	return c ^ (c >> 29);
+}
+
+
+template<typename K, typename V, typename H, typename E> int PerfectHashDictionary<K, V, H, E>::GetGroup(unsigned long long c) const
+{
+	// Multiplying and shifting maps the high bits onto [0, groups) without a division
+	return static_cast<int>(((c >> 32) * static_cast<unsigned long long>(groups_)) >> 32);
+}
+
+
+template<typename K, typename V, typename H, typename E> int PerfectHashDictionary<K, V, H, E>::GetSlot(unsigned long long c, unsigned int p) const
+{
+	unsigned long long x = (c ^ (p * 0xC2B2AE3D27D4EB4FULL)) * 0x165667B19E3779F9ULL;
+
+	return static_cast<int>(((x >> 32) * static_cast<unsigned long long>(size_)) >> 32);
+}
+
+
+template<typename K, typename V, typename H, typename E> bool PerfectHashDictionary<K, V, H, E>::SearchPilots(const unsigned long long* code, int* slot)
+{
+	// Sorts the keys by their groups, then the groups by their sizes, both by counting
+	int* start = new int[groups_ + 1];
+	int* key = new int[size_];
+	int max_size = 0;
+
+	memset(start, 0, static_cast<size_t>(groups_ + 1) * sizeof(int));
+	for (int i = 0; i < size_; i++)
+		start[GetGroup(code[i]) + 1]++;
+	for (int g = 0; g < groups_; g++)
+	{
+		if (start[g + 1] > max_size)
+			max_size = start[g + 1];
+		start[g + 1] += start[g];
+	}
+
+	int* next = new int[groups_];
+	memcpy(next, start, static_cast<size_t>(groups_) * sizeof(int));
+	for (int i = 0; i < size_; i++)
+		key[next[GetGroup(code[i])]++] = i;
+
+	int* count = new int[max_size + 2];
+	int* order = new int[groups_];
+
+	memset(count, 0, static_cast<size_t>(max_size + 2) * sizeof(int));
+	for (int g = 0; g < groups_; g++)
+		count[max_size - (start[g + 1] - start[g]) + 1]++;
+	for (int s = 0; s <= max_size; s++)
+		count[s + 1] += count[s];
+	for (int g = 0; g < groups_; g++)
+		order[count[max_size - (start[g + 1] - start[g])]++] = g;
+
+	BitMap taken(size_);
+	bool found = true;
+
+	for (int i = 0; (i < groups_) && (found == true); i++)
+	{
+		int g = order[i];
+
+		if (start[g + 1] == start[g])
+		{
+			pilot_[g] = 0;
+			continue;
+		}
+
+		unsigned int limit = (start[g + 1] - start[g] > 1) ? static_cast<unsigned int>(MAX_PILOT_) : 0xFFFFFFFFU;
+
+		found = false;
+		for (unsigned int p = 0; (p < limit) && (found == false); p++)
+		{
+			int j = start[g];
+
+			// Takes the slots one by one, and gives them back at the first collision
+			for (; j < start[g + 1]; j++)
+			{
+				int r = GetSlot(code[key[j]], p);
+
+				if (taken.Test(r) == true)
+					break;
+				taken.Set(r);
+				slot[key[j]] = r;
+			}
+
+			if (j == start[g + 1])
+			{
+				pilot_[g] = p;
+				found = true;
+			}
+			else
+				while (j > start[g])
+					taken.Clear(slot[key[--j]]);
+		}
+	}
+
+	delete[] start;
+	delete[] key;
+	delete[] next;
+	delete[] count;
+	delete[] order;
+
+	return found;
+}
+
+
+template<typename K, typename V, typename H, typename E> void PerfectHashDictionary<K, V, H, E>::Release()
+{
+	delete[] slot_;
+	slot_ = nullptr;
+	delete[] pilot_;
+	pilot_ = nullptr;
+	size_ = 0;
+	groups_ = 0;
+}
+
+
+template<typename K, typename V, typename H, typename E> PerfectHashDictionary<K, V, H, E>::PerfectHashDictionary():
+	slot_(nullptr), size_(0), pilot_(nullptr), groups_(0), seed_(0)
+{
+}
+
+
+template<typename K, typename V, typename H, typename E> PerfectHashDictionary<K, V, H, E>::~PerfectHashDictionary()
+{
+	Release();
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename D> bool PerfectHashDictionary<K, V, H, E>::Build(D& d)
+{
+	Release();
+
+	int capacity = d.GetSize();
+	const K** k = new const K*[capacity > 0 ? capacity : 1];
+	const V** v = new const V*[capacity > 0 ? capacity : 1];
+	int n = 0;
+	auto visit = [&](const K& key, const V& value)
+	{
+		if (n < capacity)
+		{
+			k[n] = &key;
+			v[n] = &value;
+			n++;
+		}
+	};
+
+	d.Traverse(visit);
+
+	// Only the entries the traversal gave are built, whatever the map reports as its size
+	size_ = n;
+	groups_ = (n + GROUP_SIZE_ - 1) / GROUP_SIZE_ + 1;
+	pilot_ = new unsigned int[groups_];
+
+	unsigned long long* code = new unsigned long long[n > 0 ? n : 1];
+	int* slot = new int[n > 0 ? n : 1];
+	bool unique = true;
+	bool found = false;
+
+	// Keys with the same hash code always share a group and a slot, whatever the seed and the pilot are
+	for (int j = 0; j < n; j++)
+		code[j] = static_cast<unsigned long long>(hash_(*k[j]));
+	std::sort(code, code + n);
+	for (int j = 1; (j < n) && (unique == true); j++)
+		if (code[j] == code[j - 1])
+			unique = false;
+
+	for (int s = 0; (s < MAX_SEED_) && (unique == true) && (found == false); s++)
+	{
+		seed_ = static_cast<unsigned long long>(s) * 0x9E3779B97F4A7C15ULL;
+		for (int j = 0; j < n; j++)
+			code[j] = GetCode(*k[j]);
+		found = SearchPilots(code, slot);
+	}
+
+	if (found == true)
+	{
+		slot_ = new Entry<K, V>[n > 0 ? n : 1];
+		for (int j = 0; j < n; j++)
+			slot_[slot[j]] = Entry<K, V>(*k[j], *v[j]);
+	}
+	else
+		Release();
+
+	delete[] k;
+	delete[] v;
+	delete[] code;
+	delete[] slot;
+
+	return found;
+}
+
+
+template<typename K, typename V, typename H, typename E> int PerfectHashDictionary<K, V, H, E>::GetSize() const
+{
+	return size_;
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> V* PerfectHashDictionary<K, V, H, E>::Get(const Q& k)
+{
+	if (size_ == 0)
+		return nullptr;
+
+	unsigned long long c = GetCode(k);
+	Entry<K, V>& e = slot_[GetSlot(c, pilot_[GetGroup(c)])];
+
+	// A key outside the set also lands on some slot, so the key there is compared once
+	return (equal_(e.key_, k) == true) ? &e.value_ : nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> int PerfectHashDictionary<K, V, H, E>::GetPilotBytes() const
+{
+	return groups_ * static_cast<int>(sizeof(unsigned int));
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename VST> void PerfectHashDictionary<K, V, H, E>::Traverse(VST& visit)
+{
+	for (int r = 0; r < size_; r++)
+		visit(slot_[r].key_, slot_[r].value_);
+}
+
+
+template<typename K, typename V, typename H, typename E> bool PerfectHashDictionary<K, V, H, E>::Save(const char* path) const
+{
+	static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value, "Save() copies the keys and the values byte by byte");
+
+	std::ofstream out(path, std::ios::binary);
+
+	if (out.is_open() == false)
+		return false;
+
+	unsigned int header[4] = { MAGIC_, static_cast<unsigned int>(sizeof(K)), static_cast<unsigned int>(sizeof(V)), static_cast<unsigned int>(size_) };
+
+	out.write(reinterpret_cast<const char*>(header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(&groups_), sizeof(groups_));
+	out.write(reinterpret_cast<const char*>(&seed_), sizeof(seed_));
+	out.write(reinterpret_cast<const char*>(pilot_), static_cast<std::streamsize>(groups_) * sizeof(unsigned int));
+	for (int r = 0; r < size_; r++)
+	{
+		out.write(reinterpret_cast<const char*>(&slot_[r].key_), sizeof(K));
+		out.write(reinterpret_cast<const char*>(&slot_[r].value_), sizeof(V));
+	}
+
+	return out.good();
+}
+
+
+template<typename K, typename V, typename H, typename E> bool PerfectHashDictionary<K, V, H, E>::Load(const char* path)
+{
+	static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value, "Load() copies the keys and the values byte by byte");
+
+	std::ifstream in(path, std::ios::binary);
+
+	if (in.is_open() == false)
+		return false;
+
+	unsigned int header[4];
+	int groups = 0;
+
+	in.read(reinterpret_cast<char*>(header), sizeof(header));
+	in.read(reinterpret_cast<char*>(&groups), sizeof(groups));
+	if ((in.good() == false) || (header[0] != MAGIC_) || (header[1] != sizeof(K)) || (header[2] != sizeof(V))
+		|| (static_cast<int>(header[3]) < 0) || (groups < 0) || ((groups == 0) && (header[3] > 0)))
+		return false;
+
+	Release();
+	size_ = static_cast<int>(header[3]);
+	groups_ = groups;
+	in.read(reinterpret_cast<char*>(&seed_), sizeof(seed_));
+	pilot_ = new unsigned int[groups_ > 0 ? groups_ : 1];
+	in.read(reinterpret_cast<char*>(pilot_), static_cast<std::streamsize>(groups_) * sizeof(unsigned int));
+	slot_ = new Entry<K, V>[size_ > 0 ? size_ : 1];
+	for (int r = 0; r < size_; r++)
+	{
+		in.read(reinterpret_cast<char*>(&slot_[r].key_), sizeof(K));
+		in.read(reinterpret_cast<char*>(&slot_[r].value_), sizeof(V));
+	}
+
+	if (in.good() == false)
+	{
+		Release();
+		return false;
+	}
+
+	return true;
+}
+
+
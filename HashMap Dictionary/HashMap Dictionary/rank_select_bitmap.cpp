@@ -0,0 +1,217 @@
+/*********************************************************************************
+
+  * FileName:       rank_select_bitmap.cpp
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The implementation of the class RankSelectBitMap
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#include "rank_select_bitmap.h"
+
+
+const int RankSelectBitMap::BLOCK_WORDS_;
+const int RankSelectBitMap::SUPERBLOCK_BLOCKS_;
+const int RankSelectBitMap::SUPERBLOCK_BITS_;
+const int RankSelectBitMap::SAMPLE_;
+
+
+int RankSelectBitMap::GetZeros(int s) const
+{
+	return s * SUPERBLOCK_BITS_ - superblock_[s];
+}
+
+
+int RankSelectBitMap::SelectInWord(unsigned long long x, int j)
+{
+	// Clears the j lowest set bits
+	for (; j > 0; j--)
+		x &= x - 1;
+
+	return CountTrailingZeros(x);
+}
+
+
+void RankSelectBitMap::Release()
+{
+	delete[] superblock_;
+	superblock_ = nullptr;
+	delete[] block_;
+	block_ = nullptr;
+	delete[] select1_;
+	select1_ = nullptr;
+	delete[] select0_;
+	select0_ = nullptr;
+}
+
+
+RankSelectBitMap::RankSelectBitMap(int n): BitMap(n), superblock_(nullptr), block_(nullptr), select1_(nullptr), select0_(nullptr)
+{
+	Build();
+}
+
+
+RankSelectBitMap::~RankSelectBitMap()
+{
+	Release();
+}
+
+
+void RankSelectBitMap::Build()
+{
+	Release();
+
+	blocks_ = (size_ + BLOCK_WORDS_ - 1) / BLOCK_WORDS_;
+	superblocks_ = (blocks_ + SUPERBLOCK_BLOCKS_ - 1) / SUPERBLOCK_BLOCKS_;
+	superblock_ = new int[superblocks_ + 1];
+	block_ = new unsigned short[blocks_ + 1];
+	ones_ = 0;
+
+	for (int b = 0; b < blocks_; b++)
+	{
+		if (b % SUPERBLOCK_BLOCKS_ == 0)
+			superblock_[b / SUPERBLOCK_BLOCKS_] = ones_;
+
+		block_[b] = static_cast<unsigned short>(ones_ - superblock_[b / SUPERBLOCK_BLOCKS_]);
+
+		for (int i = b * BLOCK_WORDS_; (i < (b + 1) * BLOCK_WORDS_) && (i < size_); i++)
+			ones_ += PopCount(map_[i]);
+	}
+
+	superblock_[superblocks_] = ones_;
+
+	int zeros = size_ * 64 - ones_;
+	select1_ = new int[ones_ / SAMPLE_ + 1];
+	select0_ = new int[zeros / SAMPLE_ + 1];
+
+	// Sample i is the superblock holding the (i * SAMPLE_)th bit, which is the last one starting at or before it
+	for (int s = 0, i = 0, j = 0; s < superblocks_; s++)
+	{
+		int next_ones = superblock_[s + 1];
+		int next_zeros = ((s + 1 < superblocks_) ? (s + 1) * SUPERBLOCK_BITS_ : size_ * 64) - next_ones;
+
+		for (; i * SAMPLE_ < next_ones; i++)
+			select1_[i] = s;
+
+		for (; j * SAMPLE_ < next_zeros; j++)
+			select0_[j] = s;
+	}
+}
+
+
+int RankSelectBitMap::Rank1(int k) const
+{
+	if (k <= 0)
+		return 0;
+
+	if (k >= size_ * 64)
+		return ones_;
+
+	int w = k >> 6, b = w / BLOCK_WORDS_;
+	int r = superblock_[b / SUPERBLOCK_BLOCKS_] + block_[b];
+
+	for (int i = b * BLOCK_WORDS_; i < w; i++)
+		r += PopCount(map_[i]);
+
+	if ((k & 63) != 0)
+		r += PopCount(map_[w] & ((1ULL << (k & 63)) - 1));
+
+	return r;
+}
+
+
+int RankSelectBitMap::Rank0(int k) const
+{
+	if (k <= 0)
+		return 0;
+
+	if (k > size_ * 64)
+		k = size_ * 64;
+
+	return k - Rank1(k);
+}
+
+
+int RankSelectBitMap::Select1(int j) const
+{
+	if ((j < 0) || (j >= ones_))
+		return -1;
+
+	// The last superblock with at most j set bits before it, between two samples
+	int lo = select1_[j / SAMPLE_];
+	int hi = ((j / SAMPLE_ + 1) * SAMPLE_ < ones_) ? select1_[j / SAMPLE_ + 1] + 1 : superblocks_;
+
+	while (hi - lo > 1)
+	{
+		int mi = (lo + hi) >> 1;
+
+		if (superblock_[mi] <= j)
+			lo = mi;
+		else
+			hi = mi;
+	}
+
+	j -= superblock_[lo];
+
+	int b = lo * SUPERBLOCK_BLOCKS_;
+
+	while ((b + 1 < (lo + 1) * SUPERBLOCK_BLOCKS_) && (b + 1 < blocks_) && (block_[b + 1] <= j))
+		b++;
+
+	j -= block_[b];
+
+	int w = b * BLOCK_WORDS_;
+
+	for (int c = PopCount(map_[w]); j >= c; c = PopCount(map_[w]))
+	{
+		j -= c;
+		w++;
+	}
+
+	return w * 64 + SelectInWord(map_[w], j);
+}
+
+
+int RankSelectBitMap::Select0(int j) const
+{
+	if ((j < 0) || (j >= size_ * 64 - ones_))
+		return -1;
+
+	int lo = select0_[j / SAMPLE_];
+	int hi = ((j / SAMPLE_ + 1) * SAMPLE_ < size_ * 64 - ones_) ? select0_[j / SAMPLE_ + 1] + 1 : superblocks_;
+
+	while (hi - lo > 1)
+	{
+		int mi = (lo + hi) >> 1;
+
+		if (GetZeros(mi) <= j)
+			lo = mi;
+		else
+			hi = mi;
+	}
+
+	j -= GetZeros(lo);
+
+	// The number of clear bits before block b + 1, counted from the start of the superblock
+	int b = lo * SUPERBLOCK_BLOCKS_;
+
+	while ((b + 1 < (lo + 1) * SUPERBLOCK_BLOCKS_) && (b + 1 < blocks_) && ((b + 1 - lo * SUPERBLOCK_BLOCKS_) * BLOCK_WORDS_ * 64 - block_[b + 1] <= j))
+		b++;
+
+	j -= (b - lo * SUPERBLOCK_BLOCKS_) * BLOCK_WORDS_ * 64 - block_[b];
+
+	int w = b * BLOCK_WORDS_;
+
+	for (int c = 64 - PopCount(map_[w]); j >= c; c = 64 - PopCount(map_[w]))
+	{
+		j -= c;
+		w++;
+	}
+
+	return w * 64 + SelectInWord(~map_[w], j);
+}
+
+
@@ -0,0 +1,122 @@
+/*********************************************************************************
+
+  * FileName:       rank_select_bitmap.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class RankSelectBitMap
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include "bitmap.h"
+
+
+/*
+* A bitmap with a rank and select index: every superblock of 2048 bits keeps the number of set bits before it,
+* and every block of 512 bits keeps the number since the start of its superblock,
+* which costs about 4.7% extra space, so that Rank1() is a few lookups and popcounts,
+* every 4096th set and clear bit keeps its superblock, so that Select1() and Select0() only search a short range,
+* the index is built by Build() and is invalid after the bits are modified until Build() is called again
+*/
+class RankSelectBitMap: public BitMap
+{
+protected:
+	// The number of words in a block
+	const static int BLOCK_WORDS_ = 8;
+	// The number of blocks in a superblock
+	const static int SUPERBLOCK_BLOCKS_ = 4;
+	// The number of bits in a superblock
+	const static int SUPERBLOCK_BITS_ = BLOCK_WORDS_ * SUPERBLOCK_BLOCKS_ * 64;
+	// The distance between the sampled set bits, and between the sampled clear bits
+	const static int SAMPLE_ = 4096;
+	// The number of set bits before each superblock
+	int* superblock_;
+	// The number of set bits before each block, counted from the start of its superblock
+	unsigned short* block_;
+	// The number of superblocks
+	int superblocks_;
+	// The number of blocks
+	int blocks_;
+	// The superblock holding every SAMPLE_th set bit
+	int* select1_;
+	// The superblock holding every SAMPLE_th clear bit
+	int* select0_;
+	// The number of set bits
+	int ones_;
+
+	/*
+	* Gets the number of clear bits before superblock s
+	* @ Parameter:
+	*       s:         The superblock
+	* @ Return:
+	*                  The number of clear bits before superblock s
+	*/
+	int GetZeros(int s) const;
+
+	/*
+	* Finds the jth set bit of a word
+	* @ Parameter:
+	*       x:         The word
+	*       j:         The index of the set bit, which must be less than the number of set bits of x
+	* @ Return:
+	*                  The position of the set bit in x
+	*/
+	static int SelectInWord(unsigned long long x, int j);
+
+	/*
+	* Releases the index
+	*/
+	void Release();
+
+public:
+	RankSelectBitMap(int n = 8);
+	~RankSelectBitMap();
+
+	/*
+	* Builds the index over the current bits
+	*/
+	void Build();
+
+	/*
+	* Gets the number of set bits before the kth bit
+	* @ Parameter:
+	*       k:         The bit
+	* @ Return:
+	*                  The number of set bits in [0, k)
+	*/
+	int Rank1(int k) const;
+
+	/*
+	* Gets the number of clear bits before the kth bit
+	* @ Parameter:
+	*       k:         The bit
+	* @ Return:
+	*                  The number of clear bits in [0, k), counting only the bits within the size of the bitmap
+	*/
+	int Rank0(int k) const;
+
+	/*
+	* Finds the jth set bit, counting from 0
+	* @ Parameter:
+	*       j:         The index of the set bit
+	* @ Return:
+	*                  The position of the jth set bit, or -1 if there are not so many set bits
+	*/
+	int Select1(int j) const;
+
+	/*
+	* Finds the jth clear bit within the size of the bitmap, counting from 0
+	* @ Parameter:
+	*       j:         The index of the clear bit
+	* @ Return:
+	*                  The position of the jth clear bit, or -1 if there are not so many clear bits
+	*/
+	int Select0(int j) const;
+};
+
+
@@ -0,0 +1,267 @@
+/*********************************************************************************
+
+  * FileName:       roaring_bitmap.cpp
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The implementation of the class RoaringBitMap
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#include <memory>
+#include "roaring_bitmap.h"
+
+
+int RoaringBitMap::Find(unsigned short high) const
+{
+	int lo = 0, hi = size_;
+
+	while (lo < hi)
+	{
+		int mi = (lo + hi) >> 1;
+
+		if (key_[mi] < high)
+			lo = mi + 1;
+		else
+			hi = mi;
+	}
+
+	return ((lo < size_) && (key_[lo] == high)) ? lo : -lo - 1;
+}
+
+
+void RoaringBitMap::Reserve(int c)
+{
+	if (c <= capacity_)
+		return;
+
+	unsigned short* old_key = key_;
+	RoaringContainer** old_container = container_;
+	capacity_ = (c > 2 * capacity_) ? c : 2 * capacity_;
+	key_ = new unsigned short[capacity_];
+	container_ = new RoaringContainer*[capacity_];
+
+	if (size_ > 0)
+	{
+		memcpy(key_, old_key, size_ * sizeof(unsigned short));
+		memcpy(container_, old_container, size_ * sizeof(RoaringContainer*));
+	}
+
+	delete[] old_key;
+	old_key = nullptr;
+	delete[] old_container;
+	old_container = nullptr;
+}
+
+
+void RoaringBitMap::CopyFrom(const RoaringBitMap& b)
+{
+	key_ = nullptr;
+	container_ = nullptr;
+	size_ = 0;
+	capacity_ = 0;
+	Reserve(b.size_);
+
+	for (int i = 0; i < b.size_; i++)
+	{
+		key_[i] = b.key_[i];
+		container_[i] = new RoaringContainer(*b.container_[i]);
+	}
+
+	size_ = b.size_;
+}
+
+
+void RoaringBitMap::Release()
+{
+	for (int i = 0; i < size_; i++)
+		delete container_[i];
+
+	delete[] key_;
+	key_ = nullptr;
+	delete[] container_;
+	container_ = nullptr;
+	size_ = 0;
+	capacity_ = 0;
+}
+
+
+RoaringBitMap::RoaringBitMap(): key_(nullptr), container_(nullptr), size_(0), capacity_(0)
+{
+}
+
+
+RoaringBitMap::RoaringBitMap(const RoaringBitMap& b)
+{
+	CopyFrom(b);
+}
+
+
+RoaringBitMap::~RoaringBitMap()
+{
+	Release();
+}
+
+
+RoaringBitMap& RoaringBitMap::operator=(const RoaringBitMap& b)
+{
+	if (this == &b)
+		return *this;
+
+	Release();
+	CopyFrom(b);
+
+	return *this;
+}
+
+
+void RoaringBitMap::Set(int k)
+{
+	if (k < 0)
+		return;
+
+	unsigned short high = static_cast<unsigned short>(static_cast<unsigned int>(k) >> 16);
+	int i = Find(high);
+
+	if (i < 0)
+	{
+		i = -i - 1;
+		Reserve(size_ + 1);
+		memmove(key_ + i + 1, key_ + i, (size_ - i) * sizeof(unsigned short));
+		memmove(container_ + i + 1, container_ + i, (size_ - i) * sizeof(RoaringContainer*));
+		key_[i] = high;
+		container_[i] = new RoaringContainer();
+		size_++;
+	}
+
+	container_[i]->Set(static_cast<unsigned short>(k & 0xFFFF));
+}
+
+
+void RoaringBitMap::Clear(int k)
+{
+	if (k < 0)
+		return;
+
+	int i = Find(static_cast<unsigned short>(static_cast<unsigned int>(k) >> 16));
+
+	if ((i < 0) || (container_[i]->Clear(static_cast<unsigned short>(k & 0xFFFF)) == false))
+		return;
+
+	// An empty chunk is dropped
+	if (container_[i]->GetCardinality() == 0)
+	{
+		delete container_[i];
+		memmove(key_ + i, key_ + i + 1, (size_ - i - 1) * sizeof(unsigned short));
+		memmove(container_ + i, container_ + i + 1, (size_ - i - 1) * sizeof(RoaringContainer*));
+		size_--;
+	}
+}
+
+
+bool RoaringBitMap::Test(int k) const
+{
+	if (k < 0)
+		return false;
+
+	int i = Find(static_cast<unsigned short>(static_cast<unsigned int>(k) >> 16));
+
+	return (i >= 0) && (container_[i]->Test(static_cast<unsigned short>(k & 0xFFFF)) == true);
+}
+
+
+int RoaringBitMap::Count() const
+{
+	int count = 0;
+
+	for (int i = 0; i < size_; i++)
+		count += container_[i]->GetCardinality();
+
+	return count;
+}
+
+
+long long RoaringBitMap::GetBytes() const
+{
+	long long bytes = capacity_ * (sizeof(unsigned short) + sizeof(RoaringContainer*));
+
+	for (int i = 0; i < size_; i++)
+		bytes += sizeof(RoaringContainer) + container_[i]->GetBytes();
+
+	return bytes;
+}
+
+
+void RoaringBitMap::Optimize()
+{
+	for (int i = 0; i < size_; i++)
+		container_[i]->Optimize();
+}
+
+
+void RoaringBitMap::And(const RoaringBitMap& b)
+{
+	int n = 0;
+
+	// Only the chunks in both bitmaps can keep set bits, the rest are dropped
+	for (int i = 0, j = 0; i < size_; i++)
+	{
+		while ((j < b.size_) && (b.key_[j] < key_[i]))
+			j++;
+
+		if ((j < b.size_) && (b.key_[j] == key_[i]))
+		{
+			container_[i]->And(*(b.container_[j]));
+
+			if (container_[i]->GetCardinality() > 0)
+			{
+				key_[n] = key_[i];
+				container_[n++] = container_[i];
+				continue;
+			}
+		}
+
+		delete container_[i];
+	}
+
+	size_ = n;
+}
+
+
+void RoaringBitMap::Or(const RoaringBitMap& b)
+{
+	int c = size_ + b.size_, n = 0, i = 0, j = 0;
+	unsigned short* key = new unsigned short[(c > 0) ? c : 1];
+	RoaringContainer** container = new RoaringContainer*[(c > 0) ? c : 1];
+
+	while ((i < size_) || (j < b.size_))
+	{
+		if ((j == b.size_) || ((i < size_) && (key_[i] < b.key_[j])))
+		{
+			key[n] = key_[i];
+			container[n++] = container_[i++];
+		}
+		else if ((i == size_) || (key_[i] > b.key_[j]))
+		{
+			key[n] = b.key_[j];
+			container[n++] = new RoaringContainer(*(b.container_[j++]));
+		}
+		else
+		{
+			container_[i]->Or(*(b.container_[j++]));
+			key[n] = key_[i];
+			container[n++] = container_[i++];
+		}
+	}
+
+	delete[] key_;
+	delete[] container_;
+	key_ = key;
+	container_ = container;
+	size_ = n;
+	capacity_ = (c > 0) ? c : 1;
+}
+
+
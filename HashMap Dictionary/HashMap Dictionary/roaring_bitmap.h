@@ -0,0 +1,136 @@
+/*********************************************************************************
+
+  * FileName:       roaring_bitmap.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class RoaringBitMap
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include "roaring_container.h"
+
+
+/*
+* A compressed bitmap in the way of Roaring: the bits are split by their high 16 bits into chunks of 65536,
+* and only the chunks holding set bits get a container, which is an array, a bitmap or runs,
+* so that the memory follows the number and the clustering of the set bits instead of the highest one
+*/
+class RoaringBitMap
+{
+protected:
+	// The sorted high 16 bits of the chunks
+	unsigned short* key_;
+	// The containers of the chunks
+	RoaringContainer** container_;
+	// The number of chunks
+	int size_;
+	// The number of chunks key_ and container_ can hold
+	int capacity_;
+
+	/*
+	* Finds the chunk with high 16 bits == high
+	* @ Parameter:
+	*       high:      The high 16 bits
+	* @ Return:
+	*                  The index of the chunk, or -(the index where it would be inserted) - 1
+	*/
+	int Find(unsigned short high) const;
+
+	/*
+	* Makes key_ and container_ hold at least c chunks
+	* @ Parameter:
+	*       c:         The number of chunks
+	*/
+	void Reserve(int c);
+
+	/*
+	* Copies the chunks of b, the bitmap must hold no memory
+	* @ Parameter:
+	*       b:         The other bitmap
+	*/
+	void CopyFrom(const RoaringBitMap& b);
+
+	/*
+	* Frees the chunks
+	*/
+	void Release();
+
+public:
+	RoaringBitMap();
+	RoaringBitMap(const RoaringBitMap& b);
+	~RoaringBitMap();
+
+	/*
+	* Overloads =
+	* @ Parameter:
+	*       b:         The other bitmap
+	* @ Return:
+	*                  The current bitmap
+	*/
+	RoaringBitMap& operator=(const RoaringBitMap& b);
+
+	/*
+	* Sets the kth bit
+	* @ Parameter:
+	*       k:         The bit, nothing is done if it is negative
+	*/
+	void Set(int k);
+
+	/*
+	* Clears the kth bit
+	* @ Parameter:
+	*       k:         The bit, nothing is done if it is negative
+	*/
+	void Clear(int k);
+
+	/*
+	* Judges whether the kth bit is set
+	* @ Parameter:
+	*       k:         The bit
+	* @ Return:
+	*                  Whether the kth bit is set
+	*/
+	bool Test(int k) const;
+
+	/*
+	* Counts the set bits
+	* @ Return:
+	*                  The number of set bits
+	*/
+	int Count() const;
+
+	/*
+	* Gets the number of bytes the chunks take
+	* @ Return:
+	*                  The number of bytes
+	*/
+	long long GetBytes() const;
+
+	/*
+	* Converts every container to the type taking the least space, runs in particular,
+	* which Set() and Clear() never create
+	*/
+	void Optimize();
+
+	/*
+	* Intersects with b
+	* @ Parameter:
+	*       b:         The other bitmap
+	*/
+	void And(const RoaringBitMap& b);
+
+	/*
+	* Unites with b
+	* @ Parameter:
+	*       b:         The other bitmap
+	*/
+	void Or(const RoaringBitMap& b);
+};
+
+
@@ -0,0 +1,579 @@
+/*********************************************************************************
+
+  * FileName:       roaring_container.cpp
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The implementation of the class RoaringContainer
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#include <memory>
+#include "roaring_container.h"
+#include "bitmap.h"
+
+
+const int RoaringContainer::ARRAY_;
+const int RoaringContainer::BITMAP_;
+const int RoaringContainer::RUN_;
+const int RoaringContainer::MAX_ARRAY_;
+const int RoaringContainer::BITMAP_WORDS_;
+
+
+int RoaringContainer::FindInArray(unsigned short x) const
+{
+	int lo = 0, hi = size_;
+
+	while (lo < hi)
+	{
+		int mi = (lo + hi) >> 1;
+
+		if (data_[mi] < x)
+			lo = mi + 1;
+		else
+			hi = mi;
+	}
+
+	return ((lo < size_) && (data_[lo] == x)) ? lo : -lo - 1;
+}
+
+
+int RoaringContainer::FindRun(unsigned short x) const
+{
+	int lo = 0, hi = size_;
+
+	while (lo < hi)
+	{
+		int mi = (lo + hi) >> 1;
+
+		if (data_[2 * mi] <= x)
+			lo = mi + 1;
+		else
+			hi = mi;
+	}
+
+	return lo - 1;
+}
+
+
+void RoaringContainer::Reserve(int c)
+{
+	if (c <= capacity_)
+		return;
+
+	int old_capacity = capacity_;
+	unsigned short* old_data = data_;
+	capacity_ = (c > 2 * capacity_) ? c : 2 * capacity_;
+	data_ = new unsigned short[capacity_];
+
+	if (old_data != nullptr)
+		memcpy(data_, old_data, old_capacity * sizeof(unsigned short));
+
+	delete[] old_data;
+	old_data = nullptr;
+}
+
+
+int RoaringContainer::CountRuns() const
+{
+	int runs = 0;
+
+	if (type_ == RUN_)
+		return size_;
+
+	if (type_ == ARRAY_)
+	{
+		for (int i = 0; i < size_; i++)
+			if ((i == 0) || (data_[i] != data_[i - 1] + 1))
+				runs++;
+
+		return runs;
+	}
+
+	// A run starts at every set bit whose lower neighbour is clear
+	unsigned long long carry = 0;
+
+	for (int i = 0; i < BITMAP_WORDS_; i++)
+	{
+		runs += BitMap::PopCount(words_[i] & ~((words_[i] << 1) | carry));
+		carry = words_[i] >> 63;
+	}
+
+	return runs;
+}
+
+
+void RoaringContainer::ToBitmap()
+{
+	if (type_ == BITMAP_)
+		return;
+
+	words_ = new unsigned long long[BITMAP_WORDS_];
+	memset(words_, 0, BITMAP_WORDS_ * sizeof(unsigned long long));
+
+	if (type_ == ARRAY_)
+	{
+		for (int i = 0; i < size_; i++)
+			words_[data_[i] >> 6] |= 1ULL << (data_[i] & 63);
+	}
+	else
+	{
+		for (int i = 0; i < size_; i++)
+		{
+			// The run [lo, hi) is set a word at a time
+			for (int lo = data_[2 * i], hi = data_[2 * i] + data_[2 * i + 1] + 1; lo < hi;)
+			{
+				int w = lo >> 6, end = ((w + 1) * 64 < hi) ? (w + 1) * 64 : hi;
+				words_[w] |= BitMap::GetMask(lo & 63, end - w * 64);
+				lo = end;
+			}
+		}
+	}
+
+	delete[] data_;
+	data_ = nullptr;
+	size_ = 0;
+	capacity_ = 0;
+	type_ = BITMAP_;
+}
+
+
+void RoaringContainer::ToArray()
+{
+	if (type_ == ARRAY_)
+		return;
+
+	unsigned short* array = new unsigned short[(cardinality_ > 0) ? cardinality_ : 1];
+	int n = 0;
+
+	if (type_ == BITMAP_)
+	{
+		for (int i = 0; i < BITMAP_WORDS_; i++)
+			for (unsigned long long w = words_[i]; w != 0; w &= w - 1)
+				array[n++] = static_cast<unsigned short>(i * 64 + BitMap::CountTrailingZeros(w));
+
+		delete[] words_;
+		words_ = nullptr;
+	}
+	else
+	{
+		for (int i = 0; i < size_; i++)
+			for (int v = data_[2 * i]; v <= data_[2 * i] + data_[2 * i + 1]; v++)
+				array[n++] = static_cast<unsigned short>(v);
+
+		delete[] data_;
+	}
+
+	data_ = array;
+	size_ = n;
+	capacity_ = (cardinality_ > 0) ? cardinality_ : 1;
+	type_ = ARRAY_;
+}
+
+
+void RoaringContainer::ToRun()
+{
+	if (type_ == RUN_)
+		return;
+
+	int runs = CountRuns(), n = 0;
+	unsigned short* run = new unsigned short[(runs > 0) ? 2 * runs : 2];
+
+	if (type_ == ARRAY_)
+	{
+		for (int i = 0; i < size_; i++)
+		{
+			if ((i > 0) && (data_[i] == data_[i - 1] + 1))
+			{
+				run[2 * n - 1]++;
+			}
+			else
+			{
+				run[2 * n] = data_[i];
+				run[2 * n + 1] = 0;
+				n++;
+			}
+		}
+
+		delete[] data_;
+	}
+	else
+	{
+		int start = -1;
+
+		for (int i = 0; i < BITMAP_WORDS_; i++)
+		{
+			// Whole words inside or outside a run are skipped
+			if (((words_[i] == 0) && (start < 0)) || ((words_[i] == ~0ULL) && (start >= 0)))
+				continue;
+
+			for (int b = 0; b < 64; b++)
+			{
+				bool set = ((words_[i] >> b) & 1) != 0;
+
+				if ((set == true) && (start < 0))
+				{
+					start = i * 64 + b;
+				}
+				else if ((set == false) && (start >= 0))
+				{
+					run[2 * n] = static_cast<unsigned short>(start);
+					run[2 * n + 1] = static_cast<unsigned short>(i * 64 + b - 1 - start);
+					n++;
+					start = -1;
+				}
+			}
+		}
+
+		if (start >= 0)
+		{
+			run[2 * n] = static_cast<unsigned short>(start);
+			run[2 * n + 1] = static_cast<unsigned short>(BITMAP_WORDS_ * 64 - 1 - start);
+			n++;
+		}
+
+		delete[] words_;
+		words_ = nullptr;
+	}
+
+	data_ = run;
+	size_ = n;
+	capacity_ = (runs > 0) ? 2 * runs : 2;
+	type_ = RUN_;
+}
+
+
+void RoaringContainer::Unpack()
+{
+	if (type_ != RUN_)
+		return;
+
+	if (cardinality_ > MAX_ARRAY_)
+		ToBitmap();
+	else
+		ToArray();
+}
+
+
+void RoaringContainer::Shrink()
+{
+	if (type_ != BITMAP_)
+		return;
+
+	cardinality_ = 0;
+
+	for (int i = 0; i < BITMAP_WORDS_; i++)
+		cardinality_ += BitMap::PopCount(words_[i]);
+
+	if (cardinality_ <= MAX_ARRAY_)
+		ToArray();
+}
+
+
+RoaringContainer::RoaringContainer(): type_(ARRAY_), cardinality_(0), data_(nullptr), size_(0), capacity_(0), words_(nullptr)
+{
+}
+
+
+void RoaringContainer::CopyFrom(const RoaringContainer& c)
+{
+	type_ = c.type_;
+	cardinality_ = c.cardinality_;
+	size_ = c.size_;
+	capacity_ = c.capacity_;
+	data_ = nullptr;
+	words_ = nullptr;
+
+	if (c.data_ != nullptr)
+	{
+		data_ = new unsigned short[capacity_];
+		memcpy(data_, c.data_, capacity_ * sizeof(unsigned short));
+	}
+
+	if (c.words_ != nullptr)
+	{
+		words_ = new unsigned long long[BITMAP_WORDS_];
+		memcpy(words_, c.words_, BITMAP_WORDS_ * sizeof(unsigned long long));
+	}
+}
+
+
+RoaringContainer::RoaringContainer(const RoaringContainer& c)
+{
+	CopyFrom(c);
+}
+
+
+RoaringContainer::~RoaringContainer()
+{
+	delete[] data_;
+	data_ = nullptr;
+	delete[] words_;
+	words_ = nullptr;
+}
+
+
+RoaringContainer& RoaringContainer::operator=(const RoaringContainer& c)
+{
+	if (this == &c)
+		return *this;
+
+	delete[] data_;
+	delete[] words_;
+	CopyFrom(c);
+
+	return *this;
+}
+
+
+int RoaringContainer::GetCardinality() const
+{
+	return cardinality_;
+}
+
+
+int RoaringContainer::GetType() const
+{
+	return type_;
+}
+
+
+int RoaringContainer::GetBytes() const
+{
+	if (type_ == BITMAP_)
+		return BITMAP_WORDS_ * sizeof(unsigned long long);
+
+	return capacity_ * sizeof(unsigned short);
+}
+
+
+bool RoaringContainer::Set(unsigned short x)
+{
+	if (Test(x) == true)
+		return false;
+
+	Unpack();
+
+	if ((type_ == ARRAY_) && (size_ == MAX_ARRAY_))
+		ToBitmap();
+
+	if (type_ == ARRAY_)
+	{
+		int i = -FindInArray(x) - 1;
+		Reserve(size_ + 1);
+		memmove(data_ + i + 1, data_ + i, (size_ - i) * sizeof(unsigned short));
+		data_[i] = x;
+		size_++;
+	}
+	else
+		words_[x >> 6] |= 1ULL << (x & 63);
+
+	cardinality_++;
+
+	return true;
+}
+
+
+bool RoaringContainer::Clear(unsigned short x)
+{
+	if (Test(x) == false)
+		return false;
+
+	Unpack();
+
+	if (type_ == ARRAY_)
+	{
+		int i = FindInArray(x);
+		memmove(data_ + i, data_ + i + 1, (size_ - i - 1) * sizeof(unsigned short));
+		size_--;
+		cardinality_--;
+	}
+	else
+	{
+		words_[x >> 6] &= ~(1ULL << (x & 63));
+		cardinality_--;
+
+		if (cardinality_ <= MAX_ARRAY_)
+			ToArray();
+	}
+
+	return true;
+}
+
+
+bool RoaringContainer::Test(unsigned short x) const
+{
+	if (type_ == ARRAY_)
+		return FindInArray(x) >= 0;
+
+	if (type_ == BITMAP_)
+		return ((words_[x >> 6] >> (x & 63)) & 1) != 0;
+
+	int i = FindRun(x);
+
+	return (i >= 0) && (x - data_[2 * i] <= data_[2 * i + 1]);
+}
+
+
+void RoaringContainer::Optimize()
+{
+	// A run takes 4 bytes, a value in an array 2 bytes, a bitmap 8KB
+	int run_bytes = 4 * CountRuns();
+	int array_bytes = 2 * cardinality_;
+	int bitmap_bytes = BITMAP_WORDS_ * sizeof(unsigned long long);
+
+	if ((run_bytes < array_bytes) && (run_bytes < bitmap_bytes))
+	{
+		ToRun();
+		return;
+	}
+
+	Unpack();
+
+	if (cardinality_ <= MAX_ARRAY_)
+		ToArray();
+	else
+		ToBitmap();
+}
+
+
+void RoaringContainer::And(const RoaringContainer& c)
+{
+	if ((type_ == ARRAY_) && (c.type_ == ARRAY_))
+	{
+		// Merges the sorted arrays in place
+		int n = 0;
+
+		for (int i = 0, j = 0; (i < size_) && (j < c.size_);)
+		{
+			if (data_[i] < c.data_[j])
+				i++;
+			else if (data_[i] > c.data_[j])
+				j++;
+			else
+			{
+				data_[n++] = data_[i];
+				i++;
+				j++;
+			}
+		}
+
+		size_ = cardinality_ = n;
+		return;
+	}
+
+	if (type_ == ARRAY_)
+	{
+		int n = 0;
+
+		for (int i = 0; i < size_; i++)
+			if (c.Test(data_[i]) == true)
+				data_[n++] = data_[i];
+
+		size_ = cardinality_ = n;
+		return;
+	}
+
+	if (c.type_ == ARRAY_)
+	{
+		unsigned short* array = new unsigned short[(c.size_ > 0) ? c.size_ : 1];
+		int n = 0;
+
+		for (int j = 0; j < c.size_; j++)
+			if (Test(c.data_[j]) == true)
+				array[n++] = c.data_[j];
+
+		delete[] data_;
+		delete[] words_;
+		words_ = nullptr;
+		data_ = array;
+		size_ = cardinality_ = n;
+		capacity_ = (c.size_ > 0) ? c.size_ : 1;
+		type_ = ARRAY_;
+		return;
+	}
+
+	// Bitmaps and runs are intersected a word at a time
+	bool run = (type_ == RUN_) && (c.type_ == RUN_);
+	ToBitmap();
+
+	if (c.type_ == BITMAP_)
+	{
+		for (int i = 0; i < BITMAP_WORDS_; i++)
+			words_[i] &= c.words_[i];
+	}
+	else
+	{
+		RoaringContainer t(c);
+		t.ToBitmap();
+
+		for (int i = 0; i < BITMAP_WORDS_; i++)
+			words_[i] &= t.words_[i];
+	}
+
+	Shrink();
+
+	if (run == true)
+		Optimize();
+}
+
+
+void RoaringContainer::Or(const RoaringContainer& c)
+{
+	if ((type_ == ARRAY_) && (c.type_ == ARRAY_) && (size_ + c.size_ <= MAX_ARRAY_))
+	{
+		unsigned short* array = new unsigned short[(size_ + c.size_ > 0) ? size_ + c.size_ : 1];
+		int n = 0, i = 0, j = 0;
+
+		while ((i < size_) || (j < c.size_))
+		{
+			if ((j == c.size_) || ((i < size_) && (data_[i] < c.data_[j])))
+				array[n++] = data_[i++];
+			else if ((i == size_) || (data_[i] > c.data_[j]))
+				array[n++] = c.data_[j++];
+			else
+			{
+				array[n++] = data_[i++];
+				j++;
+			}
+		}
+
+		delete[] data_;
+		data_ = array;
+		capacity_ = (size_ + c.size_ > 0) ? size_ + c.size_ : 1;
+		size_ = cardinality_ = n;
+		return;
+	}
+
+	bool run = (type_ == RUN_) || (c.type_ == RUN_);
+	ToBitmap();
+
+	if (c.type_ == ARRAY_)
+	{
+		for (int j = 0; j < c.size_; j++)
+			words_[c.data_[j] >> 6] |= 1ULL << (c.data_[j] & 63);
+	}
+	else if (c.type_ == BITMAP_)
+	{
+		for (int i = 0; i < BITMAP_WORDS_; i++)
+			words_[i] |= c.words_[i];
+	}
+	else
+	{
+		RoaringContainer t(c);
+		t.ToBitmap();
+
+		for (int i = 0; i < BITMAP_WORDS_; i++)
+			words_[i] |= t.words_[i];
+	}
+
+	Shrink();
+
+	// The union of runs is likely to be runs again
+	if (run == true)
+		Optimize();
+}
+
+
@@ -0,0 +1,193 @@
+/*********************************************************************************
+
+  * FileName:       roaring_container.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class RoaringContainer
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+/*
+* The set of the low 16 bits of the values sharing the same high 16 bits in a RoaringBitMap,
+* kept as a sorted array while it is sparse, as a bitmap of 65536 bits while it is dense,
+* or, after Optimize(), as sorted runs when they take the least space
+*/
+class RoaringContainer
+{
+public:
+	// The container types
+	const static int ARRAY_ = 0;
+	const static int BITMAP_ = 1;
+	const static int RUN_ = 2;
+	// The maximum number of values in an array, beyond which a bitmap takes less space
+	const static int MAX_ARRAY_ = 4096;
+	// The number of words in a bitmap
+	const static int BITMAP_WORDS_ = 1024;
+
+protected:
+	// The type of the container
+	int type_;
+	// The number of values
+	int cardinality_;
+	// The sorted values of an array, or the sorted runs as pairs of the first value and the length - 1
+	unsigned short* data_;
+	// The number of values in the array, or the number of runs
+	int size_;
+	// The number of unsigned shorts data_ can hold
+	int capacity_;
+	// The words of a bitmap
+	unsigned long long* words_;
+
+	/*
+	* Finds x in the sorted array
+	* @ Parameter:
+	*       x:         The value
+	* @ Return:
+	*                  The index of x, or -(the index where x would be inserted) - 1
+	*/
+	int FindInArray(unsigned short x) const;
+
+	/*
+	* Finds the last run starting at or before x
+	* @ Parameter:
+	*       x:         The value
+	* @ Return:
+	*                  The index of the run, or -1 if every run starts after x
+	*/
+	int FindRun(unsigned short x) const;
+
+	/*
+	* Makes data_ hold at least c unsigned shorts, keeps its content
+	* @ Parameter:
+	*       c:         The number of unsigned shorts
+	*/
+	void Reserve(int c);
+
+	/*
+	* Counts the runs of consecutive values
+	* @ Return:
+	*                  The number of runs
+	*/
+	int CountRuns() const;
+
+	/*
+	* Converts the container to a bitmap
+	*/
+	void ToBitmap();
+
+	/*
+	* Converts the container to a sorted array
+	*/
+	void ToArray();
+
+	/*
+	* Converts the container to runs
+	*/
+	void ToRun();
+
+	/*
+	* Converts runs to an array or a bitmap, whichever fits the cardinality, before they are modified
+	*/
+	void Unpack();
+
+	/*
+	* Recounts the values of a bitmap, converts it to an array if they are few
+	*/
+	void Shrink();
+
+	/*
+	* Copies the values of c, the container must hold no memory
+	* @ Parameter:
+	*       c:         The other container
+	*/
+	void CopyFrom(const RoaringContainer& c);
+
+public:
+	RoaringContainer();
+	RoaringContainer(const RoaringContainer& c);
+	~RoaringContainer();
+
+	/*
+	* Overloads =
+	* @ Parameter:
+	*       c:         The other container
+	* @ Return:
+	*                  The current container
+	*/
+	RoaringContainer& operator=(const RoaringContainer& c);
+
+	/*
+	* Gets the number of values
+	* @ Return:
+	*                  The number of values
+	*/
+	int GetCardinality() const;
+
+	/*
+	* Gets the type of the container
+	* @ Return:
+	*                  ARRAY_, BITMAP_ or RUN_
+	*/
+	int GetType() const;
+
+	/*
+	* Gets the number of bytes the values take
+	* @ Return:
+	*                  The number of bytes
+	*/
+	int GetBytes() const;
+
+	/*
+	* Inserts x
+	* @ Parameter:
+	*       x:         The value
+	* @ Return:
+	*                  Whether x is inserted, false if it is already in the container
+	*/
+	bool Set(unsigned short x);
+
+	/*
+	* Removes x
+	* @ Parameter:
+	*       x:         The value
+	* @ Return:
+	*                  Whether x is removed, false if it is not in the container
+	*/
+	bool Clear(unsigned short x);
+
+	/*
+	* Judges whether x is in the container
+	* @ Parameter:
+	*       x:         The value
+	* @ Return:
+	*                  Whether x is in the container
+	*/
+	bool Test(unsigned short x) const;
+
+	/*
+	* Converts the container to the type taking the least space
+	*/
+	void Optimize();
+
+	/*
+	* Intersects with c
+	* @ Parameter:
+	*       c:         The other container
+	*/
+	void And(const RoaringContainer& c);
+
+	/*
+	* Unites with c
+	* @ Parameter:
+	*       c:         The other container
+	*/
+	void Or(const RoaringContainer& c);
+};
+
+
@@ -0,0 +1,394 @@
+/*********************************************************************************
+
+  * FileName:       robin_hood_hashmap_dictionary.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class RobinHoodHashMapDictionary
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <utility>
+#include "hashmap_dictionary.h"
+
+
+/*
+* The Robin Hood mode of HashMapDictionary: an inserted entry takes the bucket of any entry
+* that is closer to its home bucket, so that search chains stay short even at a load factor of 7/8,
+* a search stops as soon as it meets an entry closer to home than itself,
+* and removal shifts the following entries backward instead of leaving lazy removal flags
+*/
+template<typename K, typename V, typename H = Hash<K>, typename E = KeyEqual<K>> class RobinHoodHashMapDictionary: public HashMapDictionary<K, V, H, E>
+{
+protected:
+	// The numerator of the max load factor
+	const static int MAX_LOAD_NUMERATOR_ = 7;
+	// The denominator of the max load factor
+	const static int MAX_LOAD_DENOMINATOR_ = 8;
+	// The distance of the entry in each bucket from its home bucket
+	int* distance_;
+
+	/*
+	* Searches along the search chain corresponding to k, finds the bucket that matches the entry
+	* @ Parameter:
+	*       k:         The key, or anything H and E accept in its place
+	* @ Return:
+	*                  The index, or -1 if there's no entry with key == k
+	*/
+	template<typename Q> int ProbeForHit(const Q& k);
+
+	/*
+	* Places the entry, displacing the entries that are closer to their home buckets
+	* @ Parameter:
+	*       e:         The entry, which is moved into the buckets
+	* @ Return:
+	*                  The index of the bucket taking e
+	*/
+	int Place(Entry<K, V>&& e);
+
+	/*
+	* Inserts the entry, which is not in the buckets, rehashes first if the load factor would exceed the threshold
+	* @ Parameter:
+	*       e:         The entry, which is moved into the buckets
+	* @ Return:
+	*                  The index of the bucket holding the entry
+	*/
+	int Insert(Entry<K, V>&& e);
+
+	/*
+	* Expands and rehashes the buckets, ensures the load facor is below threshold
+	*/
+	void Rehash();
+
+	/*
+	* Moves the entries into c new buckets
+	* @ Parameter:
+	*       c:         The new capacity, which comes from GetCapacity()
+	*/
+	void Resize(int c);
+
+public:
+	RobinHoodHashMapDictionary(int c = 11, bool power_of_two = false);
+	~RobinHoodHashMapDictionary();
+
+	/*
+	* Inserts an entry
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	bool Put(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k
+	*/
+	V* Get(K k);
+
+	/*
+	* Gets the value of the entry with key equal to k, without constructing a key from k
+	* @ Parameter:
+	*       k:         Anything H and E accept in place of a key
+	* @ Return:
+	*                  The value of the entry with key equal to k
+	*/
+	template<typename Q> V* Get(const Q& k);
+
+	/*
+	* Inserts an entry, or updates the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether an entry is inserted, false if the value of an entry is updated
+	*/
+	bool Upsert(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k, inserts an entry with the default value first if there's none
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k, valid until the next insertion or removal
+	*/
+	V& GetOrInsert(K k);
+
+	/*
+	* Inserts an entry whose value is constructed from a, only if there's no entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       a:         The arguments of the constructor of the value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	template<typename... A> bool TryEmplace(K k, A&&... a);
+
+	/*
+	* Removes the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  Whether removal is successful
+	*/
+	bool Remove(K k);
+
+	/*
+	* Expands the buckets once, so that n entries fit without rehashing
+	* @ Parameter:
+	*       n:         The number of entries
+	*/
+	void Reserve(int n);
+
+	/*
+	* Inserts n entries after one Reserve()
+	* @ Parameter:
+	*       k:         The keys
+	*       v:         The values
+	*       n:         The number of entries
+	*       unique:    Whether the caller guarantees that the keys are distinct and not in the map yet,
+	*                  so that the search for an equal key is skipped
+	* @ Return:
+	*                  The number of entries inserted
+	*/
+	int BulkLoad(const K* k, const V* v, int n, bool unique = false);
+};
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> int RobinHoodHashMapDictionary<K, V, H, E>::ProbeForHit(const Q& k)
+{
+	int r = this->GetHome(k), d = 0;
+
+	while ((this->IsOccupied(r) == true) && (distance_[r] >= d) && (this->equal_(this->ht_[r].key_, k) == false))
+	{
+		r = this->GetNext(r);
+		d++;
+	}
+
+	// The search stops at an empty bucket or at an entry closer to its home than k would be
+	bool hit = (this->IsOccupied(r) == true) && (distance_[r] >= d);
+
+#ifdef HASHMAP_DICTIONARY_STATS
+	this->stats_.RecordProbe(hit, d + 1);
+#endif
+
+	return (hit == true) ? r : -1;
+}
+
+
+template<typename K, typename V, typename H, typename E> int RobinHoodHashMapDictionary<K, V, H, E>::Place(Entry<K, V>&& e)
+{
+	int r = this->GetHome(e.key_), d = 0, placed = -1;
+
+	while (this->IsOccupied(r) == true)
+	{
+		if (distance_[r] < d)
+		{
+			std::swap(this->ht_[r], e);
+			std::swap(distance_[r], d);
+
+			if (placed < 0)
+				placed = r;
+		}
+
+		r = this->GetNext(r);
+		d++;
+	}
+
+	this->ht_[r] = std::move(e);
+	this->occupied_->Set(r);
+	distance_[r] = d;
+
+	return (placed >= 0) ? placed : r;
+}
+
+
+template<typename K, typename V, typename H, typename E> int RobinHoodHashMapDictionary<K, V, H, E>::Insert(Entry<K, V>&& e)
+{
+	if ((this->GetSize() + 1LL) * MAX_LOAD_DENOMINATOR_ > static_cast<long long>(this->capacity_) * MAX_LOAD_NUMERATOR_)
+		Rehash();
+
+	this->size_++;
+
+	return Place(std::move(e));
+}
+
+
+template<typename K, typename V, typename H, typename E> void RobinHoodHashMapDictionary<K, V, H, E>::Rehash()
+{
+	Resize(this->GetCapacity(2LL * this->capacity_));
+}
+
+
+template<typename K, typename V, typename H, typename E> void RobinHoodHashMapDictionary<K, V, H, E>::Resize(int c)
+{
+#ifdef HASHMAP_DICTIONARY_STATS
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#endif
+
+	int old_capacity = this->capacity_;
+	Entry<K, V>* old_ht = this->ht_;
+	BitMap* old_occupied = this->occupied_;
+	this->capacity_ = c;
+	this->ht_ = new Entry<K, V>[this->capacity_];
+	this->occupied_ = new BitMap(this->capacity_);
+
+	// Removal shifts entries back instead of marking buckets, so lazy_removal_ stays clear and is never resized
+	delete[] distance_;
+	distance_ = new int[this->capacity_];
+
+	// The entries are moved, not copied
+	for (int i = 0; i < old_capacity; i++)
+		if (old_occupied->Test(i) == true)
+			Place(std::move(old_ht[i]));
+
+	delete[] old_ht;
+	old_ht = nullptr;
+	delete old_occupied;
+	old_occupied = nullptr;
+
+#ifdef HASHMAP_DICTIONARY_STATS
+	this->stats_.RecordRehash(false, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+#endif
+}
+
+
+template<typename K, typename V, typename H, typename E> RobinHoodHashMapDictionary<K, V, H, E>::RobinHoodHashMapDictionary(int c, bool power_of_two): HashMapDictionary<K, V, H, E>(c, power_of_two)
+{
+	distance_ = new int[this->capacity_];
+}
+
+
+template<typename K, typename V, typename H, typename E> RobinHoodHashMapDictionary<K, V, H, E>::~RobinHoodHashMapDictionary()
+{
+	delete[] distance_;
+	distance_ = nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool RobinHoodHashMapDictionary<K, V, H, E>::Put(K k, V v)
+{
+	if (ProbeForHit(k) >= 0)
+		return false;
+
+	Insert(Entry<K, V>(std::move(k), std::move(v)));
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> V* RobinHoodHashMapDictionary<K, V, H, E>::Get(K k)
+{
+	int r = ProbeForHit(k);
+	return (r >= 0) ? &(this->ht_[r].value_) : nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> V* RobinHoodHashMapDictionary<K, V, H, E>::Get(const Q& k)
+{
+	int r = ProbeForHit(k);
+	return (r >= 0) ? &(this->ht_[r].value_) : nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool RobinHoodHashMapDictionary<K, V, H, E>::Upsert(K k, V v)
+{
+	int r = ProbeForHit(k);
+
+	if (r >= 0)
+	{
+		this->ht_[r].value_ = std::move(v);
+		return false;
+	}
+
+	Insert(Entry<K, V>(std::move(k), std::move(v)));
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> V& RobinHoodHashMapDictionary<K, V, H, E>::GetOrInsert(K k)
+{
+	int r = ProbeForHit(k);
+
+	if (r < 0)
+		r = Insert(Entry<K, V>(std::move(k), V()));
+
+	return this->ht_[r].value_;
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename... A> bool RobinHoodHashMapDictionary<K, V, H, E>::TryEmplace(K k, A&&... a)
+{
+	if (ProbeForHit(k) >= 0)
+		return false;
+
+	Insert(Entry<K, V>(std::move(k), V(std::forward<A>(a)...)));
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool RobinHoodHashMapDictionary<K, V, H, E>::Remove(K k)
+{
+	int r = ProbeForHit(k);
+
+	if (r < 0)
+		return false;
+
+	// Shifts the following entries of the cluster one bucket backward, until one is already at home
+	int next = this->GetNext(r);
+
+	while ((this->IsOccupied(next) == true) && (distance_[next] > 0))
+	{
+		this->ht_[r] = std::move(this->ht_[next]);
+		distance_[r] = distance_[next] - 1;
+		r = next;
+		next = this->GetNext(next);
+	}
+
+	this->ht_[r] = Entry<K, V>();
+	this->occupied_->Clear(r);
+	this->size_--;
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> void RobinHoodHashMapDictionary<K, V, H, E>::Reserve(int n)
+{
+	if (static_cast<long long>(n) * MAX_LOAD_DENOMINATOR_ <= static_cast<long long>(this->capacity_) * MAX_LOAD_NUMERATOR_)
+		return;
+
+	Resize(this->GetCapacity(static_cast<long long>(n) * MAX_LOAD_DENOMINATOR_ / MAX_LOAD_NUMERATOR_ + 1));
+}
+
+
+template<typename K, typename V, typename H, typename E> int RobinHoodHashMapDictionary<K, V, H, E>::BulkLoad(const K* k, const V* v, int n, bool unique)
+{
+	int inserted = 0;
+
+	Reserve(this->GetSize() + n);
+
+	for (int i = 0; i < n; i++)
+	{
+		if ((unique == false) && (ProbeForHit(k[i]) >= 0))
+			continue;
+
+		Insert(Entry<K, V>(k[i], v[i]));
+		inserted++;
+	}
+
+	return inserted;
+}
+
+
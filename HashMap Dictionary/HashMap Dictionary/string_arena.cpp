@@ -0,0 +1,108 @@
+/*********************************************************************************
+
+  * FileName:       string_arena.cpp
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The implementation of the class StringArena
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#include <cstring>
+#include "string_arena.h"
+
+
+const int StringArena::CHUNK_SIZE_;
+
+
+char* StringArena::NewChunk(int n, char* next)
+{
+	char* c = new char[sizeof(char*) + n];
+
+	memcpy(c, &next, sizeof(char*));
+
+	return c;
+}
+
+
+StringArena::StringArena(): chunk_(nullptr), used_(0), bytes_(0)
+{
+}
+
+
+StringArena::~StringArena()
+{
+	Release();
+}
+
+
+char* StringArena::Copy(const char* s, int n)
+{
+	char* p = nullptr;
+
+	// A long string gets a chunk of its own behind the current one, so that the rest of the current one is not wasted
+	if (n + 1 > CHUNK_SIZE_ / 4)
+	{
+		char* c = NewChunk(n + 1, nullptr);
+
+		if (chunk_ == nullptr)
+		{
+			chunk_ = c;
+			used_ = CHUNK_SIZE_;
+		}
+		else
+		{
+			char* next = nullptr;
+
+			memcpy(&next, chunk_, sizeof(next));
+			memcpy(c, &next, sizeof(next));
+			memcpy(chunk_, &c, sizeof(c));
+		}
+
+		bytes_ += static_cast<long long>(sizeof(char*)) + n + 1;
+		p = c + sizeof(char*);
+	}
+	else
+	{
+		if ((chunk_ == nullptr) || (used_ + n + 1 > CHUNK_SIZE_))
+		{
+			chunk_ = NewChunk(CHUNK_SIZE_, chunk_);
+			used_ = 0;
+			bytes_ += static_cast<long long>(sizeof(char*)) + CHUNK_SIZE_;
+		}
+
+		p = chunk_ + sizeof(char*) + used_;
+		used_ += n + 1;
+	}
+
+	memcpy(p, s, n);
+	p[n] = '\0';
+
+	return p;
+}
+
+
+void StringArena::Release()
+{
+	while (chunk_ != nullptr)
+	{
+		char* next = nullptr;
+
+		memcpy(&next, chunk_, sizeof(char*));
+		delete[] chunk_;
+		chunk_ = next;
+	}
+
+	used_ = 0;
+	bytes_ = 0;
+}
+
+
+long long StringArena::GetBytes() const
+{
+	return bytes_;
+}
+
+
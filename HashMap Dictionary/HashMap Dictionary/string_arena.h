@@ -0,0 +1,70 @@
+/*********************************************************************************
+
+  * FileName:       string_arena.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class StringArena
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+/*
+* A bump allocator for strings: copies are packed one after another into large chunks,
+* so that allocating is a pointer increment, and all of them are freed together with the chunks,
+* nothing is freed one by one
+*/
+class StringArena
+{
+protected:
+	// The number of bytes in a chunk
+	const static int CHUNK_SIZE_ = 1 << 16;
+	// The current chunk, whose first bytes point to the chunk allocated before it
+	char* chunk_;
+	// The number of bytes used in the current chunk
+	int used_;
+	// The number of bytes allocated for all the chunks
+	long long bytes_;
+
+	/*
+	* Allocates a chunk of n bytes after the link
+	* @ Parameter:
+	*       n:         The number of bytes
+	*       next:      The chunk the new one links to
+	* @ Return:
+	*                  The new chunk
+	*/
+	static char* NewChunk(int n, char* next);
+
+public:
+	StringArena();
+	~StringArena();
+
+	/*
+	* Copies n bytes and a terminating '\0' into the arena
+	* @ Parameter:
+	*       s:         Points to the bytes
+	*       n:         The number of bytes
+	* @ Return:
+	*                  The copy, valid until Release()
+	*/
+	char* Copy(const char* s, int n);
+
+	/*
+	* Frees all the copies
+	*/
+	void Release();
+
+	/*
+	* Gets the number of bytes allocated for the chunks
+	* @ Return:
+	*                  The number of bytes
+	*/
+	long long GetBytes() const;
+};
+
+
@@ -0,0 +1,406 @@
+/*********************************************************************************
+
+  * FileName:       string_hashmap_dictionary.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class StringHashMapDictionary
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <cstring>
+#include <utility>
+#include "dictionary.h"
+#include "hash.h"
+#include "string_arena.h"
+
+
+template<typename V> class StringHashMapSlot
+{
+public:
+	// The key, a copy in the arena, nullptr if the slot is empty
+	const char* key_;
+	// The length of the key
+	int length_;
+	// The low 32 bits of the hash code of the key
+	unsigned int hash_;
+	// The value
+	V value_;
+
+	StringHashMapSlot(): key_(nullptr), length_(0), hash_(0), value_()
+	{
+	}
+};
+
+
+/*
+* An open addressing hash map with linear probing for string keys, which are copied into an arena,
+* so that the caller's buffers may be reused at once, and the copies are freed together with the map,
+* every slot keeps the length and the hash code of its key, so that the keys are hashed once,
+* rehashing reads no key, and the contents are compared only after the hash code and the length match,
+* removal shifts the following entries of the cluster back, but the removed key stays in the arena until the map is freed
+*/
+template<typename V> class StringHashMapDictionary: public Dictionary<char*, V>
+{
+protected:
+	// The numerator of the max load factor
+	const static int MAX_LOAD_NUMERATOR_ = 3;
+	// The denominator of the max load factor
+	const static int MAX_LOAD_DENOMINATOR_ = 4;
+	// The slots
+	StringHashMapSlot<V>* slot_;
+	// The number of slots, a power of 2
+	int capacity_;
+	// The number of entries
+	int size_;
+	// The copies of the keys
+	StringArena arena_;
+
+	/*
+	* Hashes a string
+	* @ Parameter:
+	*       s:         Points to the string
+	*       n:         The length of the string
+	* @ Return:
+	*                  The low 32 bits of the hash code
+	*/
+	static unsigned int HashCode(const char* s, int n);
+
+	/*
+	* Searches along the search chain of the string, stops at the entry with the same key or at an empty slot
+	* @ Parameter:
+	*       s:         Points to the string
+	*       n:         The length of the string
+	*       h:         The hash code from HashCode()
+	* @ Return:
+	*                  The index of the slot
+	*/
+	int Probe(const char* s, int n, unsigned int h) const;
+
+	/*
+	* Finds the slot for a key, inserts an entry with the default value there if there's none
+	* @ Parameter:
+	*       s:         Points to the key
+	*       n:         The length of the key
+	*       inserted:  Receives whether an entry is inserted
+	* @ Return:
+	*                  The index of the slot
+	*/
+	int FindOrInsert(const char* s, int n, bool& inserted);
+
+	/*
+	* Moves the entries into c new slots, by their stored hash codes
+	* @ Parameter:
+	*       c:         The new capacity, a power of 2
+	*/
+	void Resize(int c);
+
+public:
+	StringHashMapDictionary(int c = 16);
+	~StringHashMapDictionary();
+
+	/*
+	* Gets the number of entries
+	* @ Return:
+	*                  The number of entries
+	*/
+	int GetSize() const;
+
+	/*
+	* Inserts an entry, the key is copied
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	bool Put(char* k, V v);
+
+	/*
+	* Gets the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k
+	*/
+	V* Get(char* k);
+
+	/*
+	* Gets the value of the entry whose key has the given n bytes, which need not end with '\0'
+	* @ Parameter:
+	*       s:         Points to the key
+	*       n:         The length of the key
+	* @ Return:
+	*                  The value of the entry, nullptr if there's none
+	*/
+	V* Get(const char* s, int n);
+
+	/*
+	* Inserts an entry, or updates the value of the entry with key == k, the key is copied
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether an entry is inserted, false if the value of an entry is updated
+	*/
+	bool Upsert(char* k, V v);
+
+	/*
+	* Gets the value of the entry with key == k, inserts an entry with the default value first if there's none
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k, valid until the next insertion or removal
+	*/
+	V& GetOrInsert(char* k);
+
+	/*
+	* Inserts an entry whose value is constructed from a, only if there's no entry with key == k, the key is copied
+	* @ Parameter:
+	*       k:         The key
+	*       a:         The arguments of the constructor of the value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	template<typename... A> bool TryEmplace(char* k, A&&... a);
+
+	/*
+	* Removes the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  Whether removal is successful
+	*/
+	bool Remove(char* k);
+
+	/*
+	* Gets the interned copy of the key equal to the given n bytes, inserts an entry with the default value first if there's none,
+	* so that equal strings share one copy, which can be compared by its address
+	* @ Parameter:
+	*       s:         Points to the string
+	*       n:         The length of the string
+	* @ Return:
+	*                  The copy, valid until the map is freed
+	*/
+	const char* Intern(const char* s, int n);
+
+	/*
+	* Gets the number of bytes taken by the copies of the keys, including the removed ones
+	* @ Return:
+	*                  The number of bytes
+	*/
+	long long GetArenaBytes() const;
+
+	/*
+	* Traverses the entries in the order of the slots
+	* @ Parameter:
+	*       visit:     The function object, called with the key and the value,
+	*                  which must not insert or remove entries
+	*/
+	template<typename VST> void Traverse(VST& visit);
+};
+
+
+template<typename V> unsigned int StringHashMapDictionary<V>::HashCode(const char* s, int n)
+{
+	return static_cast<unsigned int>(HashFunction::HashBytes(s, static_cast<size_t>(n)));
+}
+
+
+template<typename V> int StringHashMapDictionary<V>::Probe(const char* s, int n, unsigned int h) const
+{
+	int mask = capacity_ - 1;
+	int r = static_cast<int>(h & static_cast<unsigned int>(mask));
+
+	// The hash code and the length rule out almost every other key before its content is read
+	while ((slot_[r].key_ != nullptr)
+		&& ((slot_[r].hash_ != h) || (slot_[r].length_ != n) || (memcmp(slot_[r].key_, s, static_cast<size_t>(n)) != 0)))
+		r = (r + 1) & mask;
+
+	return r;
+}
+
+
+template<typename V> int StringHashMapDictionary<V>::FindOrInsert(const char* s, int n, bool& inserted)
+{
+	unsigned int h = HashCode(s, n);
+	int r = Probe(s, n, h);
+
+	inserted = slot_[r].key_ == nullptr;
+	if (inserted == false)
+		return r;
+
+	if ((size_ + 1) * MAX_LOAD_DENOMINATOR_ > capacity_ * MAX_LOAD_NUMERATOR_)
+	{
+		Resize(capacity_ * 2);
+		r = Probe(s, n, h);
+	}
+
+	slot_[r].key_ = arena_.Copy(s, n);
+	slot_[r].length_ = n;
+	slot_[r].hash_ = h;
+	size_++;
+
+	return r;
+}
+
+
+template<typename V> void StringHashMapDictionary<V>::Resize(int c)
+{
+	StringHashMapSlot<V>* old = slot_;
+	int old_capacity = capacity_;
+
+	slot_ = new StringHashMapSlot<V>[c];
+	capacity_ = c;
+
+	for (int i = 0; i < old_capacity; i++)
+		if (old[i].key_ != nullptr)
+		{
+			int r = static_cast<int>(old[i].hash_ & static_cast<unsigned int>(c - 1));
+
+			while (slot_[r].key_ != nullptr)
+				r = (r + 1) & (c - 1);
+			slot_[r] = std::move(old[i]);
+		}
+
+	delete[] old;
+	old = nullptr;
+}
+
+
+template<typename V> StringHashMapDictionary<V>::StringHashMapDictionary(int c): size_(0)
+{
+	capacity_ = 16;
+	while (capacity_ < c)
+		capacity_ <<= 1;
+	slot_ = new StringHashMapSlot<V>[capacity_];
+}
+
+
+template<typename V> StringHashMapDictionary<V>::~StringHashMapDictionary()
+{
+	delete[] slot_;
+	slot_ = nullptr;
+}
+
+
+template<typename V> int StringHashMapDictionary<V>::GetSize() const
+{
+	return size_;
+}
+
+
+template<typename V> bool StringHashMapDictionary<V>::Put(char* k, V v)
+{
+	bool inserted = false;
+	int r = FindOrInsert(k, static_cast<int>(strlen(k)), inserted);
+
+	if (inserted == true)
+		slot_[r].value_ = std::move(v);
+
+	return inserted;
+}
+
+
+template<typename V> V* StringHashMapDictionary<V>::Get(char* k)
+{
+	return Get(k, static_cast<int>(strlen(k)));
+}
+
+
+template<typename V> V* StringHashMapDictionary<V>::Get(const char* s, int n)
+{
+	int r = Probe(s, n, HashCode(s, n));
+
+	return (slot_[r].key_ != nullptr) ? &slot_[r].value_ : nullptr;
+}
+
+
+template<typename V> bool StringHashMapDictionary<V>::Upsert(char* k, V v)
+{
+	bool inserted = false;
+	int r = FindOrInsert(k, static_cast<int>(strlen(k)), inserted);
+
+	slot_[r].value_ = std::move(v);
+
+	return inserted;
+}
+
+
+template<typename V> V& StringHashMapDictionary<V>::GetOrInsert(char* k)
+{
+	bool inserted = false;
+	int r = FindOrInsert(k, static_cast<int>(strlen(k)), inserted);
+
+	return slot_[r].value_;
+}
+
+
+template<typename V> template<typename... A> bool StringHashMapDictionary<V>::TryEmplace(char* k, A&&... a)
+{
+	bool inserted = false;
+	int r = FindOrInsert(k, static_cast<int>(strlen(k)), inserted);
+
+	if (inserted == true)
+		slot_[r].value_ = V(std::forward<A>(a)...);
+
+	return inserted;
+}
+
+
+template<typename V> bool StringHashMapDictionary<V>::Remove(char* k)
+{
+	int n = static_cast<int>(strlen(k));
+	int mask = capacity_ - 1;
+	int r = Probe(k, n, HashCode(k, n));
+
+	if (slot_[r].key_ == nullptr)
+		return false;
+
+	// Shifts back every following entry of the cluster whose home is not between the hole and itself
+	for (int next = (r + 1) & mask; slot_[next].key_ != nullptr; next = (next + 1) & mask)
+	{
+		int home = static_cast<int>(slot_[next].hash_ & static_cast<unsigned int>(mask));
+
+		if (((next - home) & mask) >= ((next - r) & mask))
+		{
+			slot_[r] = std::move(slot_[next]);
+			r = next;
+		}
+	}
+
+	slot_[r] = StringHashMapSlot<V>();
+	size_--;
+
+	return true;
+}
+
+
+template<typename V> const char* StringHashMapDictionary<V>::Intern(const char* s, int n)
+{
+	bool inserted = false;
+	int r = FindOrInsert(s, n, inserted);
+
+	return slot_[r].key_;
+}
+
+
+template<typename V> long long StringHashMapDictionary<V>::GetArenaBytes() const
+{
+	return arena_.GetBytes();
+}
+
+
+template<typename V> template<typename VST> void StringHashMapDictionary<V>::Traverse(VST& visit)
+{
+	for (int r = 0; r < capacity_; r++)
+		if (slot_[r].key_ != nullptr)
+			visit(slot_[r].key_, slot_[r].value_);
+}
+
+
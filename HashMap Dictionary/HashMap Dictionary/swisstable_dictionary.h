@@ -0,0 +1,513 @@
+/*********************************************************************************
+
+  * FileName:       swisstable_dictionary.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class SwissTableDictionary
+  * Project:        The Data Structures - Hash Map Dictionary
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <cstring>
+#include <utility>
+#include "dictionary.h"
+#include "entry.h"
+#include "hash.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SWISSTABLE_DICTIONARY_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+/*
+* An open addressing hash map whose buckets are split into groups of 16: besides the inline entries,
+* every bucket has a control byte holding 7 bits of the hash of its key, or marking it empty or removed,
+* so that one SSE2 comparison finds the few buckets of a group that are worth comparing keys with,
+* keys are hashed by H, which must mix all the bits, and compared by E
+*/
+template<typename K, typename V, typename H = Hash<K>, typename E = KeyEqual<K>> class SwissTableDictionary: public Dictionary<K, V>
+{
+protected:
+	// The hash function
+	H hash_;
+	// The key comparison
+	E equal_;
+	// The number of buckets in a group
+	const static int GROUP_SIZE_ = 16;
+	// The control byte of an empty bucket
+	const static signed char EMPTY_ = -128;
+	// The control byte of a lazily removed bucket
+	const static signed char REMOVED_ = -2;
+	// The inline entries
+	Entry<K, V>* slot_;
+	// The control bytes, one for each bucket
+	signed char* ctrl_;
+	// The capacity of the buckets, a power of 2 and a multiple of GROUP_SIZE_
+	int capacity_;
+	// The number of entries in the buckets
+	int size_;
+	// The number of lazily removed buckets
+	int removed_;
+
+	/*
+	* Gets the buckets of the group g whose control byte == c
+	* @ Parameter:
+	*       g:         The index of the first bucket of the group
+	*       c:         The control byte
+	* @ Return:
+	*                  The bit mask of the matching buckets
+	*/
+	unsigned int Match(int g, signed char c) const;
+
+	/*
+	* Gets the buckets of the group g that are empty or lazily removed
+	* @ Parameter:
+	*       g:         The index of the first bucket of the group
+	* @ Return:
+	*                  The bit mask of the matching buckets
+	*/
+	unsigned int MatchFree(int g) const;
+
+	/*
+	* Gets the index of the lowest set bit
+	* @ Parameter:
+	*       mask:      The bit mask, which is not 0
+	* @ Return:
+	*                  The index of the lowest set bit
+	*/
+	static int LowestBit(unsigned int mask);
+
+	/*
+	* Searches the groups along the search chain corresponding to k, finds the bucket that matches the entry
+	* @ Parameter:
+	*       k:         The key, or anything H and E accept in its place
+	*       h:         The hash code of k
+	* @ Return:
+	*                  The index, or -1 if there's no entry with key == k
+	*/
+	template<typename Q> int ProbeForHit(const Q& k, size_t h) const;
+
+	/*
+	* Searches the groups along the search chain corresponding to h, finds the first bucket that can be used
+	* @ Parameter:
+	*       h:         The hash code
+	* @ Return:
+	*                  The index
+	*/
+	int ProbeForFree(size_t h) const;
+
+	/*
+	* Searches the groups along the search chain corresponding to k once, finds the bucket that matches the entry,
+	* or the first bucket that can be used if there's none
+	* @ Parameter:
+	*       k:         The key
+	*       h:         The hash code of k
+	* @ Return:
+	*                  The index, the bucket is full only if it matches the entry
+	*/
+	int ProbeForInsert(const K& k, size_t h) const;
+
+	/*
+	* Inserts the entry into bucket r found by ProbeForInsert(), rehashes first if the load factor would exceed the threshold
+	* @ Parameter:
+	*       r:         The index of the bucket
+	*       h:         The hash code of the key of e
+	*       e:         The entry, which is moved into the bucket
+	* @ Return:
+	*                  The index of the bucket holding the entry
+	*/
+	int Insert(int r, size_t h, Entry<K, V>&& e);
+
+	/*
+	* Rehashes the buckets into c buckets, the entries are moved instead of copied
+	* @ Parameter:
+	*       c:         The new capacity
+	*/
+	void Rehash(int c);
+
+public:
+	SwissTableDictionary(int c = GROUP_SIZE_);
+	~SwissTableDictionary();
+
+	/*
+	* Gets the number of entries
+	* @ Return:
+	*                  The number of entries
+	*/
+	int GetSize() const;
+
+	/*
+	* Inserts an entry
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	bool Put(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k
+	*/
+	V* Get(K k);
+
+	/*
+	* Gets the value of the entry with key equal to k, without constructing a key from k
+	* @ Parameter:
+	*       k:         Anything H and E accept in place of a key
+	* @ Return:
+	*                  The value of the entry with key equal to k
+	*/
+	template<typename Q> V* Get(const Q& k);
+
+	/*
+	* Inserts an entry, or updates the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether an entry is inserted, false if the value of an entry is updated
+	*/
+	bool Upsert(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k, inserts an entry with the default value first if there's none
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k, valid until the next insertion or removal
+	*/
+	V& GetOrInsert(K k);
+
+	/*
+	* Inserts an entry whose value is constructed from a, only if there's no entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       a:         The arguments of the constructor of the value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	template<typename... A> bool TryEmplace(K k, A&&... a);
+
+	/*
+	* Removes the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  Whether removal is successful
+	*/
+	bool Remove(K k);
+};
+
+
+template<typename K, typename V, typename H, typename E> unsigned int SwissTableDictionary<K, V, H, E>::Match(int g, signed char c) const
+{
+#ifdef SWISSTABLE_DICTIONARY_SSE2
+	__m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl_ + g));
+	return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(c), group)));
+#else
+	unsigned int mask = 0;
+
+	for (int i = 0; i < GROUP_SIZE_; i++)
+		if (ctrl_[g + i] == c)
+			mask |= (1u << i);
+
+	return mask;
+#endif
+}
+
+
+template<typename K, typename V, typename H, typename E> unsigned int SwissTableDictionary<K, V, H, E>::MatchFree(int g) const
+{
+#ifdef SWISSTABLE_DICTIONARY_SSE2
+	// The control bytes of both empty and lazily removed buckets are negative
+	__m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl_ + g));
+	return static_cast<unsigned int>(_mm_movemask_epi8(group));
+#else
+	unsigned int mask = 0;
+
+	for (int i = 0; i < GROUP_SIZE_; i++)
+		if (ctrl_[g + i] < 0)
+			mask |= (1u << i);
+
+	return mask;
+#endif
+}
+
+
+template<typename K, typename V, typename H, typename E> int SwissTableDictionary<K, V, H, E>::LowestBit(unsigned int mask)
+{
+#ifdef _MSC_VER
+	unsigned long i = 0;
+	_BitScanForward(&i, mask);
+	return static_cast<int>(i);
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> int SwissTableDictionary<K, V, H, E>::ProbeForHit(const Q& k, size_t h) const
+{
+	int groups = capacity_ / GROUP_SIZE_;
+	int g = static_cast<int>((h >> 7) & (groups - 1));
+	signed char c = static_cast<signed char>(h & 0x7F);
+	unsigned int mask = 0;
+
+	// Triangular steps visit every group when the number of groups is a power of 2
+	for (int step = 1; step <= groups; step++)
+	{
+		for (mask = Match(g * GROUP_SIZE_, c); mask != 0; mask &= mask - 1)
+		{
+			int r = g * GROUP_SIZE_ + LowestBit(mask);
+
+			if (equal_(slot_[r].key_, k) == true)
+				return r;
+		}
+
+		if (Match(g * GROUP_SIZE_, EMPTY_) != 0)
+			return -1;
+
+		g = (g + step) & (groups - 1);
+	}
+
+	return -1;
+}
+
+
+template<typename K, typename V, typename H, typename E> int SwissTableDictionary<K, V, H, E>::ProbeForFree(size_t h) const
+{
+	int groups = capacity_ / GROUP_SIZE_;
+	int g = static_cast<int>((h >> 7) & (groups - 1));
+	unsigned int mask = 0;
+
+	for (int step = 1; (mask = MatchFree(g * GROUP_SIZE_)) == 0; step++)
+		g = (g + step) & (groups - 1);
+
+	return g * GROUP_SIZE_ + LowestBit(mask);
+}
+
+
+template<typename K, typename V, typename H, typename E> int SwissTableDictionary<K, V, H, E>::ProbeForInsert(const K& k, size_t h) const
+{
+	int groups = capacity_ / GROUP_SIZE_;
+	int g = static_cast<int>((h >> 7) & (groups - 1));
+	signed char c = static_cast<signed char>(h & 0x7F);
+	int free = -1;
+	unsigned int mask = 0;
+
+	for (int step = 1; step <= groups; step++)
+	{
+		for (mask = Match(g * GROUP_SIZE_, c); mask != 0; mask &= mask - 1)
+		{
+			int r = g * GROUP_SIZE_ + LowestBit(mask);
+
+			if (equal_(slot_[r].key_, k) == true)
+				return r;
+		}
+
+		if ((free < 0) && ((mask = MatchFree(g * GROUP_SIZE_)) != 0))
+			free = g * GROUP_SIZE_ + LowestBit(mask);
+
+		if (Match(g * GROUP_SIZE_, EMPTY_) != 0)
+			break;
+
+		g = (g + step) & (groups - 1);
+	}
+
+	return free;
+}
+
+
+template<typename K, typename V, typename H, typename E> int SwissTableDictionary<K, V, H, E>::Insert(int r, size_t h, Entry<K, V>&& e)
+{
+	// Keeps the load factor of entries and lazily removed buckets below 7/8,
+	// by cleaning up when the lazily removed buckets dominate, or by doubling
+	if ((ctrl_[r] == EMPTY_) && ((size_ + 1LL + removed_) * 8 > static_cast<long long>(capacity_) * 7))
+	{
+		Rehash((removed_ > size_) ? capacity_ : 2 * capacity_);
+		r = ProbeForFree(h);
+	}
+
+	if (ctrl_[r] == REMOVED_)
+		removed_--;
+
+	ctrl_[r] = static_cast<signed char>(h & 0x7F);
+	slot_[r] = std::move(e);
+	size_++;
+
+	return r;
+}
+
+
+template<typename K, typename V, typename H, typename E> void SwissTableDictionary<K, V, H, E>::Rehash(int c)
+{
+	int old_capacity = capacity_;
+	Entry<K, V>* old_slot = slot_;
+	signed char* old_ctrl = ctrl_;
+
+	capacity_ = c;
+	slot_ = new Entry<K, V>[capacity_];
+	ctrl_ = new signed char[capacity_];
+	memset(ctrl_, EMPTY_, capacity_);
+	removed_ = 0;
+
+	for (int i = 0; i < old_capacity; i++)
+	{
+		if (old_ctrl[i] < 0)
+			continue;
+
+		size_t h = hash_(old_slot[i].key_);
+		int r = ProbeForFree(h);
+		ctrl_[r] = static_cast<signed char>(h & 0x7F);
+		slot_[r] = std::move(old_slot[i]);
+	}
+
+	delete[] old_slot;
+	old_slot = nullptr;
+	delete[] old_ctrl;
+	old_ctrl = nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> SwissTableDictionary<K, V, H, E>::SwissTableDictionary(int c)
+{
+	capacity_ = GROUP_SIZE_;
+
+	while (capacity_ < c)
+		capacity_ *= 2;
+
+	size_ = 0;
+	removed_ = 0;
+	slot_ = new Entry<K, V>[capacity_];
+	ctrl_ = new signed char[capacity_];
+	memset(ctrl_, EMPTY_, capacity_);
+}
+
+
+template<typename K, typename V, typename H, typename E> SwissTableDictionary<K, V, H, E>::~SwissTableDictionary()
+{
+	delete[] slot_;
+	slot_ = nullptr;
+	delete[] ctrl_;
+	ctrl_ = nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> int SwissTableDictionary<K, V, H, E>::GetSize() const
+{
+	return size_;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool SwissTableDictionary<K, V, H, E>::Put(K k, V v)
+{
+	size_t h = hash_(k);
+	int r = ProbeForInsert(k, h);
+
+	if (ctrl_[r] >= 0)
+		return false;
+
+	Insert(r, h, Entry<K, V>(std::move(k), std::move(v)));
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> V* SwissTableDictionary<K, V, H, E>::Get(K k)
+{
+	int r = ProbeForHit(k, hash_(k));
+	return (r >= 0) ? &(slot_[r].value_) : nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename Q> V* SwissTableDictionary<K, V, H, E>::Get(const Q& k)
+{
+	int r = ProbeForHit(k, hash_(k));
+	return (r >= 0) ? &(slot_[r].value_) : nullptr;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool SwissTableDictionary<K, V, H, E>::Upsert(K k, V v)
+{
+	size_t h = hash_(k);
+	int r = ProbeForInsert(k, h);
+
+	if (ctrl_[r] >= 0)
+	{
+		slot_[r].value_ = std::move(v);
+		return false;
+	}
+
+	Insert(r, h, Entry<K, V>(std::move(k), std::move(v)));
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> V& SwissTableDictionary<K, V, H, E>::GetOrInsert(K k)
+{
+	size_t h = hash_(k);
+	int r = ProbeForInsert(k, h);
+
+	if (ctrl_[r] < 0)
+		r = Insert(r, h, Entry<K, V>(std::move(k), V()));
+
+	return slot_[r].value_;
+}
+
+
+template<typename K, typename V, typename H, typename E> template<typename... A> bool SwissTableDictionary<K, V, H, E>::TryEmplace(K k, A&&... a)
+{
+	size_t h = hash_(k);
+	int r = ProbeForInsert(k, h);
+
+	if (ctrl_[r] >= 0)
+		return false;
+
+	Insert(r, h, Entry<K, V>(std::move(k), V(std::forward<A>(a)...)));
+
+	return true;
+}
+
+
+template<typename K, typename V, typename H, typename E> bool SwissTableDictionary<K, V, H, E>::Remove(K k)
+{
+	int r = ProbeForHit(k, hash_(k));
+
+	if (r < 0)
+		return false;
+
+	// A search never passes a group that has an empty bucket, so the bucket can be emptied again
+	// unless the group is full
+	int g = r - r % GROUP_SIZE_;
+
+	if (Match(g, EMPTY_) != 0)
+		ctrl_[r] = EMPTY_;
+	else
+	{
+		ctrl_[r] = REMOVED_;
+		removed_++;
+	}
+
+	slot_[r] = Entry<K, V>();
+	size_--;
+
+	return true;
+}
+
+
@@ -16,6 +16,13 @@
 #include "array_index_out_of_bounds_exception.h"
 
 
+// The tag selecting the constructor of ArrayForHeap which takes over a buffer,
+// so that a call copying a range (A, lo, hi) can never bind to it
+class ArrayForHeapAdopt
+{
+};
+
+
 template<typename T> class ArrayForHeap
 {
 protected:
@@ -50,6 +57,8 @@ protected:
 public:
 	ArrayForHeap(int c = DEFAULT_CAPACITY_, int s = 0, T v = static_cast<T>(0));
 	ArrayForHeap(const T* A, int n);
+	// Takes over the buffer A[0, c) allocated by new[], which holds n elements, without copying
+	ArrayForHeap(ArrayForHeapAdopt, T* A, int n, int c);
 	ArrayForHeap(const T* A, int lo, int hi);
 	ArrayForHeap(const ArrayForHeap<T>& ar);
 	ArrayForHeap(const ArrayForHeap<T>& ar, int lo, int hi);
@@ -183,6 +192,14 @@ template<typename T> ArrayForHeap<T>::ArrayForHeap(const T* A, int n)
 }
 
 
+template<typename T> ArrayForHeap<T>::ArrayForHeap(ArrayForHeapAdopt, T* A, int n, int c)
+{
+	capacity_ = c;
+	size_ = n;
+	element_ = A;
+}
+
+
 template<typename T> ArrayForHeap<T>::ArrayForHeap(const T* A, int lo, int hi)
 {
 	CopyFrom(A, lo, hi);
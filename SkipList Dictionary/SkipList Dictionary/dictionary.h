@@ -42,6 +42,25 @@ public:
 	*/
 	virtual V* Get(K k) = 0;
 
+	/*
+	* Inserts an entry, or updates the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether an entry is inserted, false if the value of an entry is updated
+	*/
+	virtual bool Upsert(K k, V v) = 0;
+
+	/*
+	* Gets the value of the entry with key == k, inserts an entry with the default value first if there's none
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k, valid until the next insertion or removal
+	*/
+	virtual V& GetOrInsert(K k) = 0;
+
 	/*
 	* Removes the entry with key == k
 	* @ Parameter:
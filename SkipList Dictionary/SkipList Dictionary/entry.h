@@ -13,6 +13,9 @@
 #pragma once
 
 
+#include <utility>
+
+
 template<typename K, typename V> class Entry
 {
 public:
@@ -21,7 +24,7 @@ public:
 	// The value
 	V value_;
 
-	Entry(K k = static_cast<K>(0), V v = static_cast<V>(0)): key_(k), value_(v)
+	Entry(K k = K(), V v = V()): key_(std::move(k)), value_(std::move(v))
 	{
 	}
 
@@ -29,6 +32,28 @@ public:
 	{
 	}
 
+	Entry(Entry<K, V>&& e): key_(std::move(e.key_)), value_(std::move(e.value_))
+	{
+	}
+
+	/*
+	* Overloads =
+	* @ Parameter:
+	*       e:         The entry
+	* @ Return:
+	*                  The current entry
+	*/
+	Entry<K, V>& operator=(const Entry<K, V>& e) { key_ = e.key_; value_ = e.value_; return *this; }
+
+	/*
+	* Overloads =, takes over the key and the value of e
+	* @ Parameter:
+	*       e:         The entry
+	* @ Return:
+	*                  The current entry
+	*/
+	Entry<K, V>& operator=(Entry<K, V>&& e) { key_ = std::move(e.key_); value_ = std::move(e.value_); return *this; }
+
 	/*
 	* Overloads <
 	* @ Parameter:
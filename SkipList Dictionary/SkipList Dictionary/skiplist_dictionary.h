@@ -13,6 +13,7 @@
 #pragma once
 
 
+#include <utility>
 #include "dictionary.h"
 #include "list.h"
 #include "quadlist.h"
@@ -32,6 +33,26 @@ protected:
 	*/
 	bool SkipSearch(ListNode<QuadList<K, V>*>*& qlist, QuadListNode<K, V>*& p, const K& k);
 
+	/*
+	* Searches for k from the top, for insertion
+	* @ Parameter:
+	*       p:         The topmost node with key == k, or the node in the bottom quadlist to insert after
+	* @ Return:
+	*                  Whether the node with key == k is found
+	*/
+	bool SearchForInsert(QuadListNode<K, V>*& p, const K& k);
+
+	/*
+	* Inserts a tower of nodes for the entry, of random height
+	* @ Parameter:
+	*       p:         The node in the bottom quadlist to insert after
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  The top node of the tower, whose value is the one Get() finds
+	*/
+	QuadListNode<K, V>* InsertTower(QuadListNode<K, V>* p, const K& k, const V& v);
+
 public:
 	/*
 	* Gets the size of the bottom quadlist
@@ -66,6 +87,35 @@ public:
 	*/
 	V* Get(K k);
 
+	/*
+	* Inserts an entry, or updates the value of the entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       v:         The value
+	* @ Return:
+	*                  Whether an entry is inserted, false if the value of an entry is updated
+	*/
+	bool Upsert(K k, V v);
+
+	/*
+	* Gets the value of the entry with key == k, inserts an entry with the default value first if there's none
+	* @ Parameter:
+	*       k:         The key
+	* @ Return:
+	*                  The value of the entry with key == k, valid until the entry is removed
+	*/
+	V& GetOrInsert(K k);
+
+	/*
+	* Inserts an entry whose value is constructed from a, only if there's no entry with key == k
+	* @ Parameter:
+	*       k:         The key
+	*       a:         The arguments of the constructor of the value
+	* @ Return:
+	*                  Whether insertion is successful
+	*/
+	template<typename... A> bool TryEmplace(K k, A&&... a);
+
 	/*
 	* Removes the entry with key == k
 	* @ Parameter:
@@ -111,19 +161,21 @@ template<typename K, typename V> int SkipListDictionary<K, V>::GetLevel() const
 }
 
 
-template<typename K, typename V> bool SkipListDictionary<K, V>::Put(K k, V v)
+template<typename K, typename V> bool SkipListDictionary<K, V>::SearchForInsert(QuadListNode<K, V>*& p, const K& k)
 {
 	if (this->IsEmpty() == true)
 		this->InsertAsFirst(new QuadList<K, V>());
 
 	ListNode<QuadList<K, V>*>* qlist = this->GetFirst();
-	QuadListNode<K, V>* p = qlist->data_->GetFirst();
+	p = qlist->data_->GetFirst();
+
+	return SkipSearch(qlist, p, k);
+}
 
-	if (SkipSearch(qlist, p, k) == true)
-		while (p->below_ != nullptr)
-			p = p->below_;
 
-	qlist = this->GetLast();
+template<typename K, typename V> QuadListNode<K, V>* SkipListDictionary<K, V>::InsertTower(QuadListNode<K, V>* p, const K& k, const V& v)
+{
+	ListNode<QuadList<K, V>*>* qlist = this->GetLast();
 	QuadListNode<K, V>* b = qlist->data_->InsertAfterAbove(k, v, p);
 	std::uniform_int_distribution<int> u(0, 1);
 	std::default_random_engine e;
@@ -147,6 +199,20 @@ template<typename K, typename V> bool SkipListDictionary<K, V>::Put(K k, V v)
 		b = qlist->data_->InsertAfterAbove(k, v, p, b);
 	}
 
+	return b;
+}
+
+
+template<typename K, typename V> bool SkipListDictionary<K, V>::Put(K k, V v)
+{
+	QuadListNode<K, V>* p = nullptr;
+
+	if (SearchForInsert(p, k) == true)
+		while (p->below_ != nullptr)
+			p = p->below_;
+
+	InsertTower(p, k, v);
+
 	return true;
 }
 
@@ -163,6 +229,48 @@ template<typename K, typename V> V* SkipListDictionary<K, V>::Get(K k)
 }
 
 
+template<typename K, typename V> bool SkipListDictionary<K, V>::Upsert(K k, V v)
+{
+	QuadListNode<K, V>* p = nullptr;
+
+	if (SearchForInsert(p, k) == false)
+	{
+		InsertTower(p, k, v);
+		return true;
+	}
+
+	// Every node of the tower keeps a copy of the entry
+	for (; p != nullptr; p = p->below_)
+		(p->entry_).value_ = v;
+
+	return false;
+}
+
+
+template<typename K, typename V> V& SkipListDictionary<K, V>::GetOrInsert(K k)
+{
+	QuadListNode<K, V>* p = nullptr;
+
+	if (SearchForInsert(p, k) == false)
+		p = InsertTower(p, k, V());
+
+	return (p->entry_).value_;
+}
+
+
+template<typename K, typename V> template<typename... A> bool SkipListDictionary<K, V>::TryEmplace(K k, A&&... a)
+{
+	QuadListNode<K, V>* p = nullptr;
+
+	if (SearchForInsert(p, k) == true)
+		return false;
+
+	InsertTower(p, k, V(std::forward<A>(a)...));
+
+	return true;
+}
+
+
 template<typename K, typename V> bool SkipListDictionary<K, V>::Remove(K k)
 {
 	if (this->IsEmpty() == true)
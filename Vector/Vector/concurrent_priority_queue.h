@@ -0,0 +1,255 @@
+/*********************************************************************************
+
+  * FileName:       concurrent_priority_queue.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class ConcurrentPriorityQueue
+  * Project:        The Data Structures - Vector
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include "priority_queue.h"
+#include "priority_queue_array_heap.h"
+
+
+template<typename T> class alignas(64) ConcurrentPriorityQueueShard
+{
+public:
+	// The array heap of the shard
+	PriorityQueueArrayHeap<T> heap_;
+	// Guards the heap
+	std::mutex lock_;
+};
+
+
+/*
+* A relaxed concurrent priority queue (MultiQueue): the elements are spread over c * P
+* independently locked array heaps, deleteMax() takes the higher top of two random shards,
+* so that the deleted element is one of the highest ones, but not always the highest one
+*/
+template<typename T> class ConcurrentPriorityQueue: public PriorityQueue<T>
+{
+protected:
+	// The number of shards
+	int shards_;
+	// Points to the shards
+	ConcurrentPriorityQueueShard<T>* shard_;
+	// The number of elements
+	std::atomic<int> size_;
+
+	/*
+	* Gets a random shard for the calling thread
+	* @ Return:
+	*                  The index of the shard
+	*/
+	int GetRandomShard();
+
+	/*
+	* Samples two shards, locks the one with the higher top and keeps it locked
+	* @ Return:
+	*                  The index of the locked shard, or -1 if both sampled shards are empty
+	*/
+	int LockHigherOfTwo();
+
+public:
+	ConcurrentPriorityQueue(int p = static_cast<int>(std::thread::hardware_concurrency()), int c = 2);
+	~ConcurrentPriorityQueue();
+
+	/*
+	* Gets the number of elements
+	* @ Return:
+	*                  The number of elements
+	*/
+	int GetSize() const;
+
+	/*
+	* Whether the queue is empty
+	* @ Return:
+	*                  Whether the queue is empty
+	*/
+	bool IsEmpty() const;
+
+	/*
+	* Inserts a new entry into a random shard
+	* @ Parameter:
+	*       e:         The element
+	*/
+	void Insert(T e);
+
+	/*
+	* Gets an element with high priority, the higher top of two random shards
+	* @ Return:
+	*                  The element with high priority
+	*/
+	T GetMax();
+
+	/*
+	* Deletes an element with high priority, the higher top of two random shards
+	* @ Return:
+	*                  The element with high priority
+	*/
+	T DeleteMax();
+
+	/*
+	* Deletes an element with high priority, the higher top of two random shards
+	* @ Parameter:
+	*       e:         The deleted element
+	* @ Return:
+	*                  Whether an element is deleted, false only when the queue is empty
+	*/
+	bool TryDeleteMax(T& e);
+};
+
+
+template<typename T> int ConcurrentPriorityQueue<T>::GetRandomShard()
+{
+	thread_local std::minstd_rand e(static_cast<unsigned int>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+	std::uniform_int_distribution<int> u(0, shards_ - 1);
+
+	return u(e);
+}
+
+
+template<typename T> int ConcurrentPriorityQueue<T>::LockHigherOfTwo()
+{
+	int i = 0, j = 0;
+
+	while (true)
+	{
+		i = GetRandomShard();
+		j = GetRandomShard();
+
+		if (i == j)
+		{
+			if (shard_[i].lock_.try_lock() == false)
+				continue;
+		}
+		else
+		{
+			// Always locks in index order, so that two threads sampling the same pair cannot deadlock
+			if (j < i)
+				std::swap(i, j);
+
+			if (shard_[i].lock_.try_lock() == false)
+				continue;
+
+			if (shard_[j].lock_.try_lock() == false)
+			{
+				shard_[i].lock_.unlock();
+				continue;
+			}
+
+			if (shard_[i].heap_.IsEmpty() == true || ((shard_[j].heap_.IsEmpty() == false) && (shard_[i].heap_.GetMax() < shard_[j].heap_.GetMax())))
+				std::swap(i, j);
+
+			shard_[j].lock_.unlock();
+		}
+
+		if (shard_[i].heap_.IsEmpty() == true)
+		{
+			shard_[i].lock_.unlock();
+			return -1;
+		}
+
+		return i;
+	}
+}
+
+
+template<typename T> ConcurrentPriorityQueue<T>::ConcurrentPriorityQueue(int p, int c): size_(0)
+{
+	shards_ = ((p > 0) ? p : 1) * ((c > 0) ? c : 1);
+	shard_ = new ConcurrentPriorityQueueShard<T>[shards_];
+}
+
+
+template<typename T> ConcurrentPriorityQueue<T>::~ConcurrentPriorityQueue()
+{
+	delete[] shard_;
+	shard_ = nullptr;
+}
+
+
+template<typename T> int ConcurrentPriorityQueue<T>::GetSize() const
+{
+	return size_.load();
+}
+
+
+template<typename T> bool ConcurrentPriorityQueue<T>::IsEmpty() const
+{
+	return !static_cast<bool>(GetSize());
+}
+
+
+template<typename T> void ConcurrentPriorityQueue<T>::Insert(T e)
+{
+	int i = GetRandomShard();
+
+	while (shard_[i].lock_.try_lock() == false)
+		i = GetRandomShard();
+
+	shard_[i].heap_.Insert(e);
+	shard_[i].lock_.unlock();
+	size_++;
+}
+
+
+template<typename T> T ConcurrentPriorityQueue<T>::GetMax()
+{
+	int i = -1;
+
+	while (i < 0 && IsEmpty() == false)
+		i = LockHigherOfTwo();
+
+	if (i < 0)
+		return static_cast<T>(0);
+
+	T max = shard_[i].heap_.GetMax();
+	shard_[i].lock_.unlock();
+
+	return max;
+}
+
+
+template<typename T> T ConcurrentPriorityQueue<T>::DeleteMax()
+{
+	T max = static_cast<T>(0);
+
+	if (TryDeleteMax(max) == false)
+		std::cout << "Warning ! You cannot call deleteMax() from an empty priority queue !\n";
+
+	return max;
+}
+
+
+template<typename T> bool ConcurrentPriorityQueue<T>::TryDeleteMax(T& e)
+{
+	int i = -1;
+
+	while (i < 0)
+	{
+		if (IsEmpty() == true)
+			return false;
+
+		i = LockHigherOfTwo();
+	}
+
+	e = shard_[i].heap_.DeleteMax();
+	shard_[i].lock_.unlock();
+	size_--;
+
+	return true;
+}
+
+
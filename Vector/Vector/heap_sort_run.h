@@ -0,0 +1,38 @@
+/*********************************************************************************
+
+  * FileName:       heap_sort_run.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class HeapSortRun
+  * Project:        The Data Structures - Vector
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+template<typename T> class HeapSortRun
+{
+public:
+	// The current element of the run
+	T data_;
+	// The index of the run
+	int run_;
+
+	HeapSortRun(T e = static_cast<T>(0), int r = 0): data_(e), run_(r)
+	{
+	}
+
+	/*
+	* Overloads <
+	* @ Parameter:
+	*       x:         The run
+	* @ Return:
+	*                  Whether the current element of this run < that of x
+	*/
+	bool operator<(const HeapSortRun<T>& x) const { return data_ < x.data_; }
+};
+
+
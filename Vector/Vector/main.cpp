@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <random>
+#include <thread>
 #include "vector.h"
+#include "concurrent_priority_queue.h"
 
 
 template<typename T> class Visit
@@ -12,6 +17,74 @@ public:
 };
 
 
+/*
+* Measures the throughput of ConcurrentPriorityQueue with p threads inserting, then deleting, the keys [0, n),
+* then the rank error of its relaxed DeleteMax() in a single thread, the number of larger keys still in the queue
+* when a key is deleted, which is kept apart from the threads so that a preempted thread holding a shard does not skew it
+* @ Parameter:
+*       n:         The number of keys
+*       p:         The number of threads
+*/
+void BenchmarkConcurrentPriorityQueue(int n, int p)
+{
+	ConcurrentPriorityQueue<int> pq(p);
+	int* key = new int[n];
+	// The Fenwick tree counting the keys still in the queue
+	int* tree = new int[n + 1]();
+	std::thread* thread = new std::thread[p];
+
+	for (int i = 0; i < n; i++)
+		key[i] = i;
+	std::shuffle(key, key + n, std::minstd_rand(2021));
+
+	auto start = std::chrono::steady_clock::now();
+	for (int t = 0; t < p; t++)
+		thread[t] = std::thread([&pq, key, n, p, t]() { for (int i = t; i < n; i += p) pq.Insert(key[i]); });
+	for (int t = 0; t < p; t++)
+		thread[t].join();
+	double insertion = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (int t = 0; t < p; t++)
+		thread[t] = std::thread([&pq, n, p, t]() { for (int i = t; i < n; i += p) pq.DeleteMax(); });
+	for (int t = 0; t < p; t++)
+		thread[t].join();
+	double removal = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	for (int i = 0; i < n; i++)
+	{
+		pq.Insert(key[i]);
+		for (int x = key[i] + 1; x <= n; x += x & -x)
+			tree[x]++;
+	}
+
+	int max_error = 0;
+	long long total_error = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		int e = pq.DeleteMax(), error = n - i;
+
+		// Subtracts the keys <= e still in the queue, leaving the larger ones
+		for (int x = e + 1; x > 0; x -= x & -x)
+			error -= tree[x];
+		for (int x = e + 1; x <= n; x += x & -x)
+			tree[x]--;
+
+		total_error += error;
+		if (error > max_error)
+			max_error = error;
+	}
+
+	std::cout << p << " threads, " << n << " keys: " << n / insertion / 1e6 << " M insertions/s, " << n / removal / 1e6 << " M deletions/s, "
+		<< "rank error mean " << static_cast<double>(total_error) / n << ", max " << max_error << '\n';
+
+	delete[] key;
+	delete[] tree;
+	delete[] thread;
+}
+
+
 int main()
 {
 	Vector<int> vec;
@@ -42,6 +115,9 @@ int main()
 
 	vec.Sort();
 	vec.Traverse(visit);
+	std::cout << '\n';
+
+	BenchmarkConcurrentPriorityQueue(1 << 20, 4);
 
 	return 0;
 }
@@ -0,0 +1,87 @@
+/*********************************************************************************
+
+  * FileName:       pairing_heap_node.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class PairingHeapNode
+  * Project:        The Data Structures - Vector
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+template<typename T> class PairingHeapNode
+{
+public:
+	// Stores the data
+	T data_;
+	// Points to the leftmost child
+	PairingHeapNode<T>* child_;
+	// Points to the left sibling, or the mother node if this node is the leftmost child
+	PairingHeapNode<T>* pred_;
+	// Points to the right sibling
+	PairingHeapNode<T>* succ_;
+
+	PairingHeapNode(T e = static_cast<T>(0));
+	~PairingHeapNode();
+
+	/*
+	* Links the node x as the leftmost child of the current node
+	* @ Parameter:
+	*       x:         The node
+	*/
+	void AddChild(PairingHeapNode<T>* x);
+
+	/*
+	* Detaches the current node (and its subtree) from its mother node and siblings
+	*/
+	void Detach();
+};
+
+
+template<typename T> PairingHeapNode<T>::PairingHeapNode(T e): data_(e), child_(nullptr), pred_(nullptr), succ_(nullptr)
+{
+}
+
+
+template<typename T> PairingHeapNode<T>::~PairingHeapNode()
+{
+	child_ = nullptr;
+	pred_ = nullptr;
+	succ_ = nullptr;
+}
+
+
+template<typename T> void PairingHeapNode<T>::AddChild(PairingHeapNode<T>* x)
+{
+	x->pred_ = this;
+	x->succ_ = child_;
+
+	if (child_ != nullptr)
+		child_->pred_ = x;
+
+	child_ = x;
+}
+
+
+template<typename T> void PairingHeapNode<T>::Detach()
+{
+	if (pred_ != nullptr)
+	{
+		if (pred_->child_ == this)
+			pred_->child_ = succ_;
+		else
+			pred_->succ_ = succ_;
+	}
+
+	if (succ_ != nullptr)
+		succ_->pred_ = pred_;
+
+	pred_ = nullptr;
+	succ_ = nullptr;
+}
+
+
@@ -13,14 +13,29 @@
 #pragma once
 
 
+#include <climits>
 #include <iostream>
+#include <thread>
 #include "priority_queue.h"
 #include "array_for_heap.h"
 
 
-template<typename T> class PriorityQueueArrayHeap : public PriorityQueue<T>, public ArrayForHeap<T>
+/*
+* The array heap, with H == 0 the nodes are laid out level by level (2i + 1, 2i + 2),
+* with H > 0 the tree is cut into blocks of H levels (2^H - 1 nodes) stored contiguously (B-heap),
+* so that a percolation touches a new cache line or page only once every H levels,
+* e.g. H = 4 fits a block of ints into a cache line, H = 10 fits it into a 4KB page
+*/
+template<typename T, int H = 0> class PriorityQueueArrayHeap : public PriorityQueue<T>, public ArrayForHeap<T>
 {
 protected:
+	// The number of nodes in a block
+	const static int BLOCK_SIZE_ = (1 << H) - 1;
+	// The number of child blocks of a block
+	const static int BLOCK_FANOUT_ = 1 << H;
+	// The minimum number of nodes heapified by a thread
+	const static int PARALLEL_THRESHOLD_ = 1 << 16;
+
 	/*
 	* Judges whether the index i is valid
 	* @ Parameter:
@@ -133,9 +148,38 @@ protected:
 	*/
 	void Heapify();
 
+	/*
+	* Floyd heapify algorithm restricted to the ancestors of the nodes [lo, size), in O(size - lo + log^2(size))
+	* @ Parameter:
+	*       lo:        The first node appended after the heap [0, lo)
+	*/
+	void HeapifyAbove(int lo);
+
+	/*
+	* Floyd heapify algorithm on the subtree rooted at node i, the two subtrees of a node are heapified
+	* by different threads as long as threads remain, since they share no nodes
+	* @ Parameter:
+	*       i:         The index of node i
+	*       threads:   The number of threads
+	*/
+	void ParallelHeapify(int i, int threads);
+
+	/*
+	* Gets floor(log2(n))
+	* @ Parameter:
+	*       n:         The given number
+	* @ Return:
+	*                  floor(log2(n))
+	*/
+	static int Log2(int n);
+
 public:
 	PriorityQueueArrayHeap();
+	// Takes over the buffer A[0, n) allocated by new[] and heapifies it in place
 	PriorityQueueArrayHeap(T* A, int n);
+	// Takes over the buffer A[0, n) allocated by new[] and heapifies it in place with at most the given number of threads,
+	// each heapifying at least PARALLEL_THRESHOLD_ nodes
+	PriorityQueueArrayHeap(T* A, int n, int threads);
 
 	/*
 	* Inserts a new entry
@@ -144,6 +188,15 @@ public:
 	*/
 	void Insert(T e);
 
+	/*
+	* Inserts k new entries, by percolating up each of them, or by appending all of them and heapifying,
+	* whichever is cheaper
+	* @ Parameter:
+	*       A:         The elements
+	*       k:         The number of elements
+	*/
+	void InsertMany(const T* A, int k);
+
 	/*
 	* Gets the element with the highest priority
 	* @ Return:
@@ -160,61 +213,112 @@ public:
 };
 
 
-template<typename T> bool PriorityQueueArrayHeap<T>::InHeap(int i)
+template<typename T, int H> bool PriorityQueueArrayHeap<T, H>::InHeap(int i)
 {
 	return (i >= 0) && (i < this->GetSize());
 }
 
 
-template<typename T> int PriorityQueueArrayHeap<T>::Parent(int i)
+template<typename T, int H> int PriorityQueueArrayHeap<T, H>::Parent(int i)
 {
-	return (i - 1) / 2;
+	if (H == 0)
+		return (i - 1) / 2;
+
+	int b = i / BLOCK_SIZE_, l = i % BLOCK_SIZE_;
+
+	if (l > 0)
+		return b * BLOCK_SIZE_ + (l - 1) / 2;
+
+	// The root of block b hangs below the ((b - 1) % F / 2)th leaf of block (b - 1) / F
+	return ((b - 1) / BLOCK_FANOUT_) * BLOCK_SIZE_ + BLOCK_SIZE_ / 2 + ((b - 1) % BLOCK_FANOUT_) / 2;
 }
 
 
-template<typename T> int PriorityQueueArrayHeap<T>::LastInternal()
+template<typename T, int H> int PriorityQueueArrayHeap<T, H>::LastInternal()
 {
-	return Parent(this->GetSize() - 1);
+	if (H == 0)
+		return Parent(this->GetSize() - 1);
+
+	if (this->GetSize() <= 1)
+		return this->GetSize() - 1;
+
+	// Parent() is not monotone across blocks, so the candidates are the parent of the last node,
+	// the parent of the root of the last block, and the last internal node of the last full block
+	int last = this->GetSize() - 1, b = last / BLOCK_SIZE_;
+	int max = Parent(last);
+
+	if (b > 0)
+	{
+		if (Parent(b * BLOCK_SIZE_) > max)
+			max = Parent(b * BLOCK_SIZE_);
+
+		if ((BLOCK_SIZE_ > 1) && ((b - 1) * BLOCK_SIZE_ + BLOCK_SIZE_ / 2 - 1 > max))
+			max = (b - 1) * BLOCK_SIZE_ + BLOCK_SIZE_ / 2 - 1;
+	}
+
+	return max;
 }
 
 
-template<typename T> int PriorityQueueArrayHeap<T>::LChild(int i)
+template<typename T, int H> int PriorityQueueArrayHeap<T, H>::LChild(int i)
 {
-	return 2 * i + 1;
+	if (H == 0)
+		return 2 * i + 1;
+
+	int b = i / BLOCK_SIZE_, l = i % BLOCK_SIZE_;
+
+	if (2 * l + 1 < BLOCK_SIZE_)
+		return b * BLOCK_SIZE_ + 2 * l + 1;
+
+	// The children of the jth leaf of block b are the roots of blocks b * F + 2j + 1 and b * F + 2j + 2,
+	// which may lie far beyond the last node, so the index saturates instead of overflowing
+	long long c = (static_cast<long long>(b) * BLOCK_FANOUT_ + 2 * (l - BLOCK_SIZE_ / 2) + 1) * BLOCK_SIZE_;
+
+	return (c < INT_MAX) ? static_cast<int>(c) : INT_MAX;
 }
 
 
-template<typename T> int PriorityQueueArrayHeap<T>::RChild(int i)
+template<typename T, int H> int PriorityQueueArrayHeap<T, H>::RChild(int i)
 {
-	return 2 * i + 2;
+	if (H == 0)
+		return 2 * i + 2;
+
+	int b = i / BLOCK_SIZE_, l = i % BLOCK_SIZE_;
+
+	if (2 * l + 1 < BLOCK_SIZE_)
+		return b * BLOCK_SIZE_ + 2 * l + 2;
+
+	long long c = (static_cast<long long>(b) * BLOCK_FANOUT_ + 2 * (l - BLOCK_SIZE_ / 2) + 2) * BLOCK_SIZE_;
+
+	return (c < INT_MAX) ? static_cast<int>(c) : INT_MAX;
 }
 
 
-template<typename T> bool PriorityQueueArrayHeap<T>::HasParent(int i)
+template<typename T, int H> bool PriorityQueueArrayHeap<T, H>::HasParent(int i)
 {
 	return i > 0;
 }
 
 
-template<typename T> bool PriorityQueueArrayHeap<T>::HasLChild(int i)
+template<typename T, int H> bool PriorityQueueArrayHeap<T, H>::HasLChild(int i)
 {
 	return InHeap(LChild(i)) == true;
 }
 
 
-template<typename T> bool PriorityQueueArrayHeap<T>::HasRChild(int i)
+template<typename T, int H> bool PriorityQueueArrayHeap<T, H>::HasRChild(int i)
 {
 	return InHeap(RChild(i)) == true;
 }
 
 
-template<typename T> int PriorityQueueArrayHeap<T>::GetHigher(int i, int j)
+template<typename T, int H> int PriorityQueueArrayHeap<T, H>::GetHigher(int i, int j)
 {
 	return (this->element_[i] < this->element_[j]) ? j : i;
 }
 
 
-template<typename T> int PriorityQueueArrayHeap<T>::GetMaxOfThree(int i)
+template<typename T, int H> int PriorityQueueArrayHeap<T, H>::GetMaxOfThree(int i)
 {
 	int lc = LChild(i), rc = RChild(i), max = 0;
 
@@ -232,7 +336,7 @@ template<typename T> int PriorityQueueArrayHeap<T>::GetMaxOfThree(int i)
 }
 
 
-template<typename T> int PriorityQueueArrayHeap<T>::PercolateDown(int i)
+template<typename T, int H> int PriorityQueueArrayHeap<T, H>::PercolateDown(int i)
 {
 	T temp = static_cast<T>(0);
 	int j = GetMaxOfThree(i);
@@ -250,7 +354,7 @@ template<typename T> int PriorityQueueArrayHeap<T>::PercolateDown(int i)
 }
 
 
-template<typename T> int PriorityQueueArrayHeap<T>::PercolateUp(int i)
+template<typename T, int H> int PriorityQueueArrayHeap<T, H>::PercolateUp(int i)
 {
 	int j = 0;
 	T temp = static_cast<T>(0);
@@ -272,38 +376,143 @@ template<typename T> int PriorityQueueArrayHeap<T>::PercolateUp(int i)
 }
 
 
-template<typename T> void PriorityQueueArrayHeap<T>::Heapify()
+template<typename T, int H> void PriorityQueueArrayHeap<T, H>::Heapify()
 {
 	for (int i = LastInternal(); InHeap(i) == true; i--)
 		PercolateDown(i);
 }
 
 
-template<typename T> PriorityQueueArrayHeap<T>::PriorityQueueArrayHeap()
+template<typename T, int H> void PriorityQueueArrayHeap<T, H>::HeapifyAbove(int lo)
+{
+	if (H != 0 || lo == 0)
+	{
+		Heapify();
+		return;
+	}
+
+	// In the level-by-level layout, every mother node precedes its children, so the ancestors of [lo, size)
+	// are handled in descending order, one contiguous range per level
+	int hi = Parent(this->GetSize() - 1);
+	lo = Parent(lo);
+
+	while (true)
+	{
+		for (int i = hi; i >= lo; i--)
+			PercolateDown(i);
+
+		if (lo == 0)
+			break;
+
+		hi = (Parent(hi) < lo - 1) ? Parent(hi) : lo - 1;
+		lo = Parent(lo);
+	}
+}
+
+
+template<typename T, int H> void PriorityQueueArrayHeap<T, H>::ParallelHeapify(int i, int threads)
 {
+	if (InHeap(i) == false || HasLChild(i) == false)
+		return;
+
+	if (threads > 1)
+	{
+		std::thread left([this, i, threads]() { ParallelHeapify(LChild(i), threads / 2); });
+		ParallelHeapify(RChild(i), threads - threads / 2);
+		left.join();
+	}
+	else
+	{
+		ParallelHeapify(LChild(i), 1);
+		ParallelHeapify(RChild(i), 1);
+	}
+
+	PercolateDown(i);
 }
 
 
-template<typename T> PriorityQueueArrayHeap<T>::PriorityQueueArrayHeap(T* A, int n) : ArrayForHeap<T>(A, n)
+template<typename T, int H> int PriorityQueueArrayHeap<T, H>::Log2(int n)
+{
+	int log = 0;
+
+	while (n > 1)
+	{
+		n >>= 1;
+		log++;
+	}
+
+	return log;
+}
+
+
+template<typename T, int H> PriorityQueueArrayHeap<T, H>::PriorityQueueArrayHeap()
+{
+}
+
+
+template<typename T, int H> PriorityQueueArrayHeap<T, H>::PriorityQueueArrayHeap(T* A, int n) : ArrayForHeap<T>(ArrayForHeapAdopt(), A, n, n)
 {
 	Heapify();
 }
 
 
-template<typename T> void PriorityQueueArrayHeap<T>::Insert(T e)
+template<typename T, int H> PriorityQueueArrayHeap<T, H>::PriorityQueueArrayHeap(T* A, int n, int threads) : ArrayForHeap<T>(ArrayForHeapAdopt(), A, n, n)
+{
+	// Every split halves the threads along with the nodes, so that each thread keeps about n / threads nodes
+	if (threads > n / PARALLEL_THRESHOLD_)
+		threads = n / PARALLEL_THRESHOLD_;
+
+	if (threads > 1)
+		ParallelHeapify(0, threads);
+	else
+		Heapify();
+}
+
+
+template<typename T, int H> void PriorityQueueArrayHeap<T, H>::Insert(T e)
 {
 	ArrayForHeap<T>::Insert(e);
 	PercolateUp(this->GetSize() - 1);
 }
 
 
-template<typename T> T PriorityQueueArrayHeap<T>::GetMax()
+template<typename T, int H> void PriorityQueueArrayHeap<T, H>::InsertMany(const T* A, int k)
+{
+	int n = this->GetSize(), log = Log2(n + k);
+
+	// Few elements: percolating up costs O(log(n)) each
+	if (k <= log)
+	{
+		for (int i = 0; i < k; i++)
+			Insert(A[i]);
+
+		return;
+	}
+
+	// Otherwise, each of them costs O(log(n)) while heapifying costs O(n + k) in total,
+	// or only O(k + log^2(n)) when the affected subtrees are contiguous
+	if (H != 0 && static_cast<long long>(k) * log < 2LL * (n + k))
+	{
+		for (int i = 0; i < k; i++)
+			Insert(A[i]);
+
+		return;
+	}
+
+	for (int i = 0; i < k; i++)
+		ArrayForHeap<T>::Insert(A[i]);
+
+	HeapifyAbove(n);
+}
+
+
+template<typename T, int H> T PriorityQueueArrayHeap<T, H>::GetMax()
 {
 	return this->element_[0];
 }
 
 
-template<typename T> T PriorityQueueArrayHeap<T>::DeleteMax()
+template<typename T, int H> T PriorityQueueArrayHeap<T, H>::DeleteMax()
 {
 	if (this->GetSize() == 0)
 	{
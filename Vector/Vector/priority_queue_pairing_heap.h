@@ -0,0 +1,279 @@
+/*********************************************************************************
+
+  * FileName:       priority_queue_pairing_heap.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class PriorityQueuePairingHeap
+  * Project:        The Data Structures - Vector
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <iostream>
+#include "priority_queue.h"
+#include "pairing_heap_node.h"
+
+
+template<typename T> class PriorityQueuePairingHeap: public PriorityQueue<T>
+{
+protected:
+	// The number of elements in the heap
+	int size_;
+	// Points to the root node
+	PairingHeapNode<T>* root_;
+
+	/*
+	* Links two heaps, the lower root becomes the leftmost child of the higher one
+	* @ Parameter:
+	*       x:         The root of the first heap
+	*       y:         The root of the second heap
+	* @ Return:
+	*                  The root of the linked heap
+	*/
+	PairingHeapNode<T>* Link(PairingHeapNode<T>* x, PairingHeapNode<T>* y);
+
+	/*
+	* Two-pass pairing of a sibling list
+	* @ Parameter:
+	*       x:         The first node of the sibling list
+	* @ Return:
+	*                  The root of the combined heap
+	*/
+	PairingHeapNode<T>* CombineSiblings(PairingHeapNode<T>* x);
+
+	/*
+	* Frees the heap whose root node is x
+	* @ Parameter:
+	*       x:         The root node
+	*/
+	void Clear(PairingHeapNode<T>* x);
+
+public:
+	PriorityQueuePairingHeap();
+	~PriorityQueuePairingHeap();
+
+	/*
+	* Gets the number of elements
+	* @ Return:
+	*                  The number of elements
+	*/
+	int GetSize() const;
+
+	/*
+	* Whether the heap is empty
+	* @ Return:
+	*                  Whether the heap is empty
+	*/
+	bool IsEmpty() const;
+
+	/*
+	* Inserts a new entry
+	* @ Parameter:
+	*       e:         The element
+	*/
+	void Insert(T e);
+
+	/*
+	* Inserts a new entry, in amortized O(1)
+	* @ Parameter:
+	*       e:         The element
+	* @ Return:
+	*                  The handle of the new entry, valid until it is deleted
+	*/
+	PairingHeapNode<T>* InsertAsNode(T e);
+
+	/*
+	* Raises the priority of an entry
+	* @ Parameter:
+	*       x:         The handle of the entry
+	*       e:         The new element, which must not be lower than the old one
+	*/
+	void IncreaseKey(PairingHeapNode<T>* x, T e);
+
+	/*
+	* Gets the element with the highest priority
+	* @ Return:
+	*                  The element with the highest priority
+	*/
+	T GetMax();
+
+	/*
+	* Deletes the element with the highest priority
+	* @ Return:
+	*                  The element with the highest priority
+	*/
+	T DeleteMax();
+};
+
+
+template<typename T> PairingHeapNode<T>* PriorityQueuePairingHeap<T>::Link(PairingHeapNode<T>* x, PairingHeapNode<T>* y)
+{
+	if (x == nullptr)
+		return y;
+
+	if (y == nullptr)
+		return x;
+
+	if (x->data_ < y->data_)
+	{
+		y->AddChild(x);
+		return y;
+	}
+
+	x->AddChild(y);
+	return x;
+}
+
+
+template<typename T> PairingHeapNode<T>* PriorityQueuePairingHeap<T>::CombineSiblings(PairingHeapNode<T>* x)
+{
+	if (x == nullptr)
+		return nullptr;
+
+	PairingHeapNode<T>* paired = nullptr;
+	PairingHeapNode<T>* a = nullptr;
+	PairingHeapNode<T>* b = nullptr;
+
+	// First pass: links the siblings in pairs from left to right, chains the results reversely through succ_
+	while (x != nullptr)
+	{
+		a = x;
+		b = x->succ_;
+		x = (b != nullptr) ? b->succ_ : nullptr;
+		a->pred_ = a->succ_ = nullptr;
+
+		if (b != nullptr)
+			b->pred_ = b->succ_ = nullptr;
+
+		a = Link(a, b);
+		a->succ_ = paired;
+		paired = a;
+	}
+
+	// Second pass: links the pairs from right to left
+	PairingHeapNode<T>* root = paired;
+	paired = paired->succ_;
+	root->succ_ = nullptr;
+
+	while (paired != nullptr)
+	{
+		a = paired;
+		paired = paired->succ_;
+		a->succ_ = nullptr;
+		root = Link(root, a);
+	}
+
+	return root;
+}
+
+
+template<typename T> void PriorityQueuePairingHeap<T>::Clear(PairingHeapNode<T>* x)
+{
+	PairingHeapNode<T>* next = nullptr;
+
+	while (x != nullptr)
+	{
+		if (x->child_ != nullptr)
+		{
+			// Rotates the leftmost child into the sibling list, so that no recursion is needed
+			next = x->child_;
+			x->child_ = next->succ_;
+			next->succ_ = x;
+			x = next;
+			continue;
+		}
+
+		next = x->succ_;
+		delete x;
+		x = next;
+	}
+}
+
+
+template<typename T> PriorityQueuePairingHeap<T>::PriorityQueuePairingHeap(): size_(0), root_(nullptr)
+{
+}
+
+
+template<typename T> PriorityQueuePairingHeap<T>::~PriorityQueuePairingHeap()
+{
+	Clear(root_);
+	root_ = nullptr;
+}
+
+
+template<typename T> int PriorityQueuePairingHeap<T>::GetSize() const
+{
+	return size_;
+}
+
+
+template<typename T> bool PriorityQueuePairingHeap<T>::IsEmpty() const
+{
+	return !static_cast<bool>(GetSize());
+}
+
+
+template<typename T> void PriorityQueuePairingHeap<T>::Insert(T e)
+{
+	InsertAsNode(e);
+}
+
+
+template<typename T> PairingHeapNode<T>* PriorityQueuePairingHeap<T>::InsertAsNode(T e)
+{
+	PairingHeapNode<T>* x = new PairingHeapNode<T>(e);
+	root_ = Link(root_, x);
+	size_++;
+
+	return x;
+}
+
+
+template<typename T> void PriorityQueuePairingHeap<T>::IncreaseKey(PairingHeapNode<T>* x, T e)
+{
+	if (e < x->data_)
+	{
+		std::cout << "Warning ! increaseKey() cannot lower the priority of an entry !\n";
+		return;
+	}
+
+	x->data_ = e;
+
+	if (x == root_)
+		return;
+
+	x->Detach();
+	root_ = Link(root_, x);
+}
+
+
+template<typename T> T PriorityQueuePairingHeap<T>::GetMax()
+{
+	return root_->data_;
+}
+
+
+template<typename T> T PriorityQueuePairingHeap<T>::DeleteMax()
+{
+	if (GetSize() == 0)
+	{
+		std::cout << "Warning ! You cannot call deleteMax() from an empty priority queue !\n";
+		return static_cast<T>(0);
+	}
+
+	PairingHeapNode<T>* old_root = root_;
+	T max = old_root->data_;
+	root_ = CombineSiblings(old_root->child_);
+	delete old_root;
+	old_root = nullptr;
+	size_--;
+
+	return max;
+}
+
+
@@ -0,0 +1,211 @@
+/*********************************************************************************
+
+  * FileName:       priority_queue_radix_heap.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class PriorityQueueRadixHeap
+  * Project:        The Data Structures - Vector
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <iostream>
+#include <limits>
+#include "priority_queue.h"
+#include "vector.h"
+#include "radix_heap_monotonicity_exception.h"
+#include "radix_heap_negative_key_exception.h"
+
+
+/*
+* A monotone priority queue for non-negative integer keys: every inserted element
+* must not be higher than the last deleted maximum, as in event simulation or
+* shortest paths, element x lives in the bucket indexed by the bit length of (last ^ x)
+*/
+template<typename T> class PriorityQueueRadixHeap: public PriorityQueue<T>
+{
+protected:
+	// The number of buckets
+	const static int BUCKETS_ = 8 * sizeof(T) + 1;
+	// The number of elements in the heap
+	int size_;
+	// The last deleted maximum, all the elements are <= last_
+	T last_;
+	// The buckets
+	Vector<T> bucket_[BUCKETS_];
+
+	/*
+	* Gets the number of significant bits of x
+	* @ Parameter:
+	*       x:         The given number
+	* @ Return:
+	*                  The number of significant bits of x
+	*/
+	static int BitLength(unsigned long long x);
+
+	/*
+	* Gets the bucket of the element e
+	* @ Parameter:
+	*       e:         The element
+	* @ Return:
+	*                  The index of the bucket
+	*/
+	int GetBucket(const T& e) const;
+
+	/*
+	* Makes bucket 0 non-empty, by redistributing the first non-empty bucket around its maximum
+	*/
+	void Pull();
+
+public:
+	PriorityQueueRadixHeap();
+
+	/*
+	* Gets the number of elements
+	* @ Return:
+	*                  The number of elements
+	*/
+	int GetSize() const;
+
+	/*
+	* Whether the heap is empty
+	* @ Return:
+	*                  Whether the heap is empty
+	*/
+	bool IsEmpty() const;
+
+	/*
+	* Inserts a new entry
+	* @ Parameter:
+	*       e:         The element, which must be non-negative and <= the last deleted maximum
+	*/
+	void Insert(T e);
+
+	/*
+	* Gets the element with the highest priority
+	* @ Return:
+	*                  The element with the highest priority
+	*/
+	T GetMax();
+
+	/*
+	* Deletes the element with the highest priority
+	* @ Return:
+	*                  The element with the highest priority
+	*/
+	T DeleteMax();
+};
+
+
+template<typename T> int PriorityQueueRadixHeap<T>::BitLength(unsigned long long x)
+{
+	int n = 0;
+
+	for (int shift = 32; shift > 0; shift /= 2)
+	{
+		if ((x >> shift) != 0)
+		{
+			x >>= shift;
+			n += shift;
+		}
+	}
+
+	return n + static_cast<int>(x);
+}
+
+
+template<typename T> int PriorityQueueRadixHeap<T>::GetBucket(const T& e) const
+{
+	return BitLength(static_cast<unsigned long long>(last_) ^ static_cast<unsigned long long>(e));
+}
+
+
+template<typename T> void PriorityQueueRadixHeap<T>::Pull()
+{
+	if (bucket_[0].IsEmpty() == false)
+		return;
+
+	int i = 1;
+
+	while (bucket_[i].IsEmpty() == true)
+		i++;
+
+	Vector<T>& from = bucket_[i];
+	T max = from[0];
+
+	for (Rank r = 1; r < from.GetSize(); r++)
+		if (max < from[r])
+			max = from[r];
+
+	// Every element in bucket i differs from the new last_ below bit i - 1, hence moves to a lower bucket
+	last_ = max;
+
+	for (Rank r = 0; r < from.GetSize(); r++)
+		bucket_[GetBucket(from[r])].Insert(from[r]);
+
+	from.Remove(0, from.GetSize());
+}
+
+
+template<typename T> PriorityQueueRadixHeap<T>::PriorityQueueRadixHeap(): size_(0), last_(std::numeric_limits<T>::max())
+{
+}
+
+
+template<typename T> int PriorityQueueRadixHeap<T>::GetSize() const
+{
+	return size_;
+}
+
+
+template<typename T> bool PriorityQueueRadixHeap<T>::IsEmpty() const
+{
+	return !static_cast<bool>(GetSize());
+}
+
+
+template<typename T> void PriorityQueueRadixHeap<T>::Insert(T e)
+{
+	// A negative key of a signed T would sign-extend into a bit length beyond the buckets
+	if (e < T())
+		throw RadixHeapNegativeKeyException();
+
+	if (last_ < e)
+		throw RadixHeapMonotonicityException();
+
+	bucket_[GetBucket(e)].Insert(e);
+	size_++;
+}
+
+
+template<typename T> T PriorityQueueRadixHeap<T>::GetMax()
+{
+	if (GetSize() == 0)
+		return last_;
+
+	Pull();
+
+	return last_;
+}
+
+
+template<typename T> T PriorityQueueRadixHeap<T>::DeleteMax()
+{
+	if (GetSize() == 0)
+	{
+		std::cout << "Warning ! You cannot call deleteMax() from an empty priority queue !\n";
+		return last_;
+	}
+
+	Pull();
+	bucket_[0].Remove(bucket_[0].GetSize() - 1);
+	size_--;
+
+	return last_;
+}
+
+
@@ -0,0 +1,141 @@
+/*********************************************************************************
+
+  * FileName:       priority_queue_trace.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class PriorityQueueTrace
+  * Project:        The Data Structures - Vector
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <chrono>
+#include "priority_queue.h"
+#include "vector.h"
+
+
+/*
+* Records a sequence of priority queue operations, and replays it against
+* different PriorityQueue implementations to pick the fastest one
+*/
+template<typename T> class PriorityQueueTrace
+{
+protected:
+	// The operation code of insert()
+	const static int INSERT_ = 0;
+	// The operation code of deleteMax()
+	const static int DELETE_MAX_ = 1;
+	// The recorded operations
+	Vector<int> operation_;
+	// The recorded elements of insert()
+	Vector<T> element_;
+
+public:
+	/*
+	* Gets the number of recorded operations
+	* @ Return:
+	*                  The number of recorded operations
+	*/
+	int GetSize() const;
+
+	/*
+	* Records an insert()
+	* @ Parameter:
+	*       e:         The inserted element
+	*/
+	void RecordInsert(const T& e);
+
+	/*
+	* Records a deleteMax()
+	*/
+	void RecordDeleteMax();
+
+	/*
+	* Replays the trace
+	* @ Parameter:
+	*       pq:        The priority queue, which should be empty
+	* @ Return:
+	*                  The elapsed time in seconds
+	*/
+	double Replay(PriorityQueue<T>& pq) const;
+
+	/*
+	* Replays the trace against every candidate and picks the fastest one
+	* @ Parameter:
+	*       candidate: The priority queues, which should be empty
+	*       n:         The number of candidates
+	* @ Return:
+	*                  The index of the fastest candidate
+	*/
+	int PickFastest(PriorityQueue<T>** candidate, int n) const;
+};
+
+
+template<typename T> const int PriorityQueueTrace<T>::INSERT_;
+
+
+template<typename T> const int PriorityQueueTrace<T>::DELETE_MAX_;
+
+
+template<typename T> int PriorityQueueTrace<T>::GetSize() const
+{
+	return operation_.GetSize();
+}
+
+
+template<typename T> void PriorityQueueTrace<T>::RecordInsert(const T& e)
+{
+	operation_.Insert(INSERT_);
+	element_.Insert(e);
+}
+
+
+template<typename T> void PriorityQueueTrace<T>::RecordDeleteMax()
+{
+	operation_.Insert(DELETE_MAX_);
+}
+
+
+template<typename T> double PriorityQueueTrace<T>::Replay(PriorityQueue<T>& pq) const
+{
+	Rank j = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (Rank i = 0; i < operation_.GetSize(); i++)
+	{
+		if (operation_[i] == INSERT_)
+			pq.Insert(element_[j++]);
+		else
+			pq.DeleteMax();
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	return elapsed.count();
+}
+
+
+template<typename T> int PriorityQueueTrace<T>::PickFastest(PriorityQueue<T>** candidate, int n) const
+{
+	int best = 0;
+	double best_time = 0.0, t = 0.0;
+
+	for (int i = 0; i < n; i++)
+	{
+		t = Replay(*candidate[i]);
+
+		if (i == 0 || t < best_time)
+		{
+			best = i;
+			best_time = t;
+		}
+	}
+
+	return best;
+}
+
+
@@ -0,0 +1,28 @@
+/*********************************************************************************
+
+  * FileName:       radix_heap_monotonicity_exception.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class RadixHeapMonotonicityException
+  * Project:        The Data Structures - Vector
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <exception>
+
+
+class RadixHeapMonotonicityException: public std::exception
+{
+public:
+	virtual const char* what() const throw()
+	{
+		return "insert() cannot put an element higher than the last deleted maximum into a RadixHeap !";
+	}
+};
+
+
@@ -0,0 +1,28 @@
+/*********************************************************************************
+
+  * FileName:       radix_heap_negative_key_exception.h
+  * Author:         Lenard Zhang
+  * Version:        V1.00
+  * Description:    The header file for the class RadixHeapNegativeKeyException
+  * Project:        The Data Structures - Vector
+  * Reference:      THU Data Structures
+
+**********************************************************************************/
+
+
+#pragma once
+
+
+#include <exception>
+
+
+class RadixHeapNegativeKeyException: public std::exception
+{
+public:
+	virtual const char* what() const throw()
+	{
+		return "insert() cannot put a negative element into a RadixHeap !";
+	}
+};
+
+
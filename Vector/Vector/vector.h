@@ -14,7 +14,9 @@
 
 
 #include <random>
+#include <thread>
 #include "fibonacci.h"
+#include "heap_sort_run.h"
 #include "priority_queue_array_heap.h"
 #include "vector_index_out_of_bounds_exception.h"
 
@@ -28,6 +30,8 @@ template<typename T> class Vector
 protected:
 	// The default initial capacity
 	const static int DEFAULT_CAPACITY_ = 11;
+	// The minimum number of elements handled by a thread
+	const static int PARALLEL_THRESHOLD_ = 1 << 16;
 	// The size of vector = the number of elements currently in vector
 	Rank size_;
 	// The capacity of vector
@@ -128,13 +132,42 @@ protected:
 	void QuickSort(Rank lo, Rank hi);
 
 	/*
-	* Heap sort algorithm
+	* Gets the number of threads worth using for n elements
+	* @ Parameter:
+	*       n:         The number of elements
+	* @ Return:
+	*                  The number of threads
+	*/
+	static int GetThreads(Rank n);
+
+	/*
+	* Cuts [lo, hi) into runs of nearly the same size
+	* @ Parameter:
+	*       lo:        The lower bound
+	*       hi:        The upper bound
+	*       runs:      The number of runs
+	* @ Return:
+	*                  The bounds of the runs, run i is [bound[i], bound[i + 1])
+	*/
+	static Rank* GetRunBounds(Rank lo, Rank hi, int runs);
+
+	/*
+	* Heap sort algorithm, large ranges are cut into runs that are heap sorted by different threads,
+	* and then merged through a heap of the runs' last elements
 	* @ Parameter:
 	*       lo:        The lower bound
 	*       hi:        The upper bound
 	*/
 	void HeapSort(Rank lo, Rank hi);
 
+	/*
+	* Heap sort algorithm in a single thread
+	* @ Parameter:
+	*       lo:        The lower bound
+	*       hi:        The upper bound
+	*/
+	void SerialHeapSort(Rank lo, Rank hi);
+
 public:
 	Vector(int c = DEFAULT_CAPACITY_, Rank s = 0, T v = static_cast<T>(0));
 	Vector(const T* A, Rank n);
@@ -271,6 +304,17 @@ public:
 	*/
 	Rank Insert(const T& e);
 
+	/*
+	* Gets the k highest elements, large vectors are cut into runs whose k highest elements are selected
+	* by different threads through heaps, and then selected again through a heap
+	* @ Parameter:
+	*       k:         The number of elements
+	*       A:         The buffer that receives the elements in descending order
+	* @ Return:
+	*                  The number of elements received, min(k, size)
+	*/
+	int TopK(int k, T* A) const;
+
 	/*
 	* Sorts vector[lo, hi)
 	* @ Parameter:
@@ -549,12 +593,94 @@ template<typename T> void Vector<T>::QuickSort(Rank lo, Rank hi)
 }
 
 
+template<typename T> int Vector<T>::GetThreads(Rank n)
+{
+	int threads = static_cast<int>(std::thread::hardware_concurrency());
+
+	if (threads > n / PARALLEL_THRESHOLD_)
+		threads = n / PARALLEL_THRESHOLD_;
+
+	return (threads > 1) ? threads : 1;
+}
+
+
+template<typename T> Rank* Vector<T>::GetRunBounds(Rank lo, Rank hi, int runs)
+{
+	Rank* bound = new Rank[runs + 1];
+
+	for (int i = 0; i <= runs; i++)
+		bound[i] = lo + static_cast<Rank>(static_cast<long long>(hi - lo) * i / runs);
+
+	return bound;
+}
+
+
 template<typename T> void Vector<T>::HeapSort(Rank lo, Rank hi)
 {
 	if (lo < 0 || lo > GetSize() || hi < 0 || hi > GetSize())
 		throw VectorIndexOutOfBoundsException();
 
-	PriorityQueueArrayHeap<T> heap(element_ + lo, hi - lo);
+	int runs = GetThreads(hi - lo);
+
+	if (runs == 1)
+	{
+		SerialHeapSort(lo, hi);
+		return;
+	}
+
+	Rank* bound = GetRunBounds(lo, hi, runs);
+	std::thread* worker = new std::thread[runs];
+
+	for (int i = 0; i < runs; i++)
+		worker[i] = std::thread([this, bound, i]() { SerialHeapSort(bound[i], bound[i + 1]); });
+
+	for (int i = 0; i < runs; i++)
+		worker[i].join();
+
+	// Merges the sorted runs from the back, the heap holds the last unmerged element of each run
+	T* B = new T[hi - lo];
+	Rank* end = new Rank[runs];
+	HeapSortRun<T>* tail = new HeapSortRun<T>[runs];
+
+	for (int i = 0; i < runs; i++)
+	{
+		end[i] = bound[i + 1] - 1;
+		tail[i] = HeapSortRun<T>(element_[end[i]], i);
+	}
+
+	PriorityQueueArrayHeap<HeapSortRun<T>> heap(tail, runs);
+
+	for (Rank k = hi - lo - 1; k >= 0; k--)
+	{
+		HeapSortRun<T> max = heap.DeleteMax();
+		B[k] = max.data_;
+
+		if (end[max.run_] > bound[max.run_])
+			heap.Insert(HeapSortRun<T>(element_[--end[max.run_]], max.run_));
+	}
+
+	for (Rank i = lo; i < hi; i++)
+		element_[i] = B[i - lo];
+
+	delete[] B;
+	B = nullptr;
+	delete[] end;
+	end = nullptr;
+	delete[] worker;
+	worker = nullptr;
+	delete[] bound;
+	bound = nullptr;
+}
+
+
+template<typename T> void Vector<T>::SerialHeapSort(Rank lo, Rank hi)
+{
+	T* A = new T[hi - lo];
+
+	for (Rank i = lo; i < hi; i++)
+		A[i - lo] = element_[i];
+
+	PriorityQueueArrayHeap<T> heap(A, hi - lo);
 
 	while (heap.IsEmpty() == false)
 		element_[--hi] = heap.DeleteMax();
@@ -724,6 +850,67 @@ template<typename T> Rank Vector<T>::Insert(const T& e)
 }
 
 
+template<typename T> int Vector<T>::TopK(int k, T* A) const
+{
+	if (k > GetSize())
+		k = GetSize();
+
+	if (k <= 0)
+		return 0;
+
+	int runs = GetThreads(GetSize());
+	Rank* bound = GetRunBounds(0, GetSize(), runs);
+	T* candidate = new T[static_cast<long long>(runs) * k];
+	int* selected = new int[runs];
+	std::thread* worker = new std::thread[runs];
+
+	for (int i = 0; i < runs; i++)
+	{
+		worker[i] = std::thread([this, bound, candidate, selected, i, k]()
+		{
+			Rank n = bound[i + 1] - bound[i];
+			T* run = new T[n];
+
+			for (Rank j = 0; j < n; j++)
+				run[j] = element_[bound[i] + j];
+
+			PriorityQueueArrayHeap<T> heap(run, n);
+			selected[i] = (k < n) ? k : n;
+
+			for (int j = 0; j < selected[i]; j++)
+				candidate[static_cast<long long>(i) * k + j] = heap.DeleteMax();
+		});
+	}
+
+	for (int i = 0; i < runs; i++)
+		worker[i].join();
+
+	// The k highest elements are among the k highest elements of every run
+	int n = 0;
+	T* merged = new T[static_cast<long long>(runs) * k];
+
+	for (int i = 0; i < runs; i++)
+		for (int j = 0; j < selected[i]; j++)
+			merged[n++] = candidate[static_cast<long long>(i) * k + j];
+
+	PriorityQueueArrayHeap<T> heap(merged, n);
+
+	for (int j = 0; j < k; j++)
+		A[j] = heap.DeleteMax();
+
+	delete[] worker;
+	worker = nullptr;
+	delete[] selected;
+	selected = nullptr;
+	delete[] candidate;
+	candidate = nullptr;
+	delete[] bound;
+	bound = nullptr;
+
+	return k;
+}
+
+
 template<typename T> void Vector<T>::Sort(Rank lo, Rank hi)
 {
 	if (lo < 0 || lo > GetSize() || hi < 0 || hi > GetSize())